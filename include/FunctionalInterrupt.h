@@ -2,33 +2,50 @@
 #define FUNCTIONAL_INTERRUPT_H
 
 #include <Arduino.h>
-#include <functional>
-#include <Wire.h>
+#include <new>
+#include <type_traits>
 
 #ifndef IRAM_ATTR
 #define IRAM_ATTR
 #endif
 
 // 1. attachInterrupt の曖昧さ回避
-static std::function<void(void)> _interrupt_callback = nullptr;
-static void IRAM_ATTR _interrupt_wrapper()
-{
-    if (_interrupt_callback)
-        _interrupt_callback();
-}
+// Pin interrupts with a context, without std::function. Each GPIOTE channel
+// has a slot {handler, ctx} behind its own ISR trampoline; callables such as
+// std::bind(&CST816S::handleISR, this) are copied into the slot's fixed
+// storage. No heap, and one table for the whole program
+// (src/functional_interrupt.cpp).
 
-inline void attachInterrupt(uint8_t pin, std::function<void(void)> callback, int mode)
-{
-    _interrupt_callback = callback;
-    ::attachInterrupt(digitalPinToInterrupt(pin), _interrupt_wrapper, (uint32_t)mode);
-}
+#define FI_SLOTS 8            // GPIOTE channels
+#define FI_CALLABLE_BYTES 24  // bound state per slot (member fn + this)
+
+typedef void (*fi_handler_t)(void *ctx);
+
+// Route `pin` to handler(ctx); attaching a pin again replaces its handler.
+// False when every slot is taken.
+bool fi_attach(uint8_t pin, fi_handler_t handler, void *ctx, uint32_t mode);
+
+void fi_detach(uint8_t pin);
 
-// 2. Wire.begin(sda, scl) のエラーを回避するための「ダミー関数」
-// CST816S.cpp の中だけで有効な、引数2つの begin を定義します
-namespace
-{
-    // Wire.begin(x, y) が呼ばれたら、中身のないこれ（引数2つのbegin）が呼ばれるようにします
-    // ただし、これだと解決しない場合があるため、最も安全なのは「マクロを narrow (限定)」することです
+// Detach `pin` and reserve a slot for it; returns the slot's callable
+// storage, or NULL when every slot is taken
+void *fi_claim(uint8_t pin);
+
+template <typename F> void fi_call(void *ctx) { (*static_cast<F *>(ctx))(); }
+
+// Plain functions keep going to the core's attachInterrupt()
+template <typename F,
+          typename std::enable_if<
+              !std::is_convertible<F, void (*)(void)>::value, int>::type = 0>
+inline void attachInterrupt(uint8_t pin, F callback, int mode) {
+  static_assert(sizeof(F) <= FI_CALLABLE_BYTES && alignof(F) <= 8,
+                "callable does not fit an interrupt slot");
+  static_assert(std::is_trivially_destructible<F>::value,
+                "interrupt callables are never destroyed");
+
+  void *storage = fi_claim(pin);
+  if (storage != NULL)
+    fi_attach(pin, fi_call<F>, new (storage) F(callback), (uint32_t)mode);
 }
 
-#endif
\ No newline at end of file
+#endif
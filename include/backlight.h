@@ -0,0 +1,36 @@
+#ifndef BACKLIGHT_H
+#define BACKLIGHT_H
+
+#include <stdint.h>
+
+// Perceptual gamma applied to levels before they become PWM duty
+#define BACKLIGHT_GAMMA 2.2f
+
+// Duration of one ramp step (one sequence entry)
+#define BACKLIGHT_STEP_MS 4
+
+typedef void (*backlight_done_cb_t)(void);
+
+// Claim a PWM instance for `pin`. `active_high` is false when a low level
+// turns the backlight on. False if the instance is already in use; the
+// backlight is then only switched on and off, without fades.
+bool backlight_init(uint8_t pin, bool active_high);
+
+// Jump to `level` (0-255, perceptual). Cancels a running fade.
+void backlight_set(uint8_t level);
+
+// Fade from the current level to `level` over `ms`. The ramp is played by
+// the PWM peripheral (EasyDMA sequence), the CPU is not involved. A running
+// fade is retargeted from wherever it is; its callback is dropped.
+// `cb` (may be NULL) runs from backlight_service() once the ramp has ended.
+void backlight_fade_to(uint8_t level, uint16_t ms, backlight_done_cb_t cb);
+
+// Current perceptual level (interpolated while a fade is running).
+uint8_t backlight_level(void);
+
+bool backlight_fading(void);
+
+// Run the completion callback of a finished fade. Call from loop().
+void backlight_service(void);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CLOCK_SPRITES_H
+#define CLOCK_SPRITES_H
+
+#include <lvgl.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One pre-rendered hand position. Offsets are relative to the pivot.
+typedef struct {
+  int8_t x;
+  int8_t y;
+  uint8_t w;
+  uint8_t h;
+  uint32_t offset; // into clock_sprite_set_t::data
+} clock_sprite_frame_t;
+
+// A hand rendered at `positions` angles per turn. Only the first quadrant
+// (`stored` = positions / 4 frames) is kept; the rest are quarter turns.
+// Pixels are A4, two per byte (high nibble first), rows byte aligned.
+typedef struct {
+  uint16_t positions;
+  uint16_t stored;
+  const clock_sprite_frame_t *frames;
+  const uint8_t *data;
+} clock_sprite_set_t;
+
+// Generated at build time by tools/gen_hand_sprites.py
+extern const clock_sprite_set_t clock_sprite_hour;
+extern const clock_sprite_set_t clock_sprite_min;
+extern const clock_sprite_set_t clock_sprite_sec;
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+typedef struct {
+  const clock_sprite_set_t *set;
+  lv_color_t color;
+  int16_t pos; // position index, -1 when hidden
+} clock_sprite_hand_t;
+
+// Draw `count` hands (back to front) on top of `face`, pivoting on its
+// centre. `hands` must stay valid while the face exists.
+void clock_sprites_attach(lv_obj_t *face, clock_sprite_hand_t *hands,
+                          uint8_t count);
+
+// Move a hand to `pos` (-1 hides it). Invalidates only the old and new
+// sprite rectangles. Returns false if nothing changed.
+bool clock_sprites_set(lv_obj_t *face, clock_sprite_hand_t *hand, int16_t pos);
+
+// Total time spent blitting hands, in microseconds
+uint32_t clock_sprites_render_us(void);
+
+#endif
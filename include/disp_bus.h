@@ -0,0 +1,39 @@
+#ifndef DISP_BUS_H
+#define DISP_BUS_H
+
+#include "disp_flush.h"
+#include <stdint.h>
+
+// ST7789 bus on a dedicated SPIM3, the only nRF52840 SPIM that clocks above
+// 8 MHz. CS and DC are driven by the SPIM3 hardware (CSN / DCX) from the
+// TFT_CS / TFT_DC build flags, SCK / MOSI from TFT_SCLK / TFT_MOSI.
+// TFT_eSPI only runs the panel init sequence; afterwards every byte to the
+// panel goes through here.
+
+#ifndef DISP_BUS_HZ
+#define DISP_BUS_HZ SPI_FREQUENCY
+#endif
+
+// Panel RAM is 240x320; a 240x280 glass sits in its middle rows
+#define DISP_BUS_COL_OFFSET ((240 - TFT_WIDTH) / 2)
+#define DISP_BUS_ROW_OFFSET ((320 - TFT_HEIGHT) / 2)
+
+// Claim SPIM3 once the panel is initialised (tft.begin(); SPI.end();).
+void disp_bus_init(uint32_t hz);
+
+// 8, 16 or 32 MHz; other values round down. Bus must be idle.
+void disp_bus_set_freq(uint32_t hz);
+
+// Power the SPIM down while the panel sleeps (applies errata 195)
+void disp_bus_enable(bool on);
+
+// Blocking transfers; the bus must be idle (disp_flush_wait()). Data must be
+// in RAM (EasyDMA cannot read flash).
+void disp_bus_command(uint8_t cmd, const uint8_t *data, uint8_t len);
+void disp_bus_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+void disp_bus_write(const uint8_t *data, uint32_t len);
+
+// Pixel payload backend for disp_flush_init()
+extern const disp_flush_backend_t disp_bus_backend;
+
+#endif
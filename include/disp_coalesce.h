@@ -0,0 +1,26 @@
+#ifndef DISP_COALESCE_H
+#define DISP_COALESCE_H
+
+#include <lvgl.h>
+
+// Fixed cost of one extra flushed area, in bytes of pixel payload.
+// On the wire an area costs CASET + RASET + RAMWR (11 bytes) plus DC/CS
+// toggling; on the CPU it costs one flush_cb, one DMA setup and one
+// completion IRQ (~25 us, i.e. ~100 bytes at 32 MHz).
+#ifndef DISP_COALESCE_AREA_COST
+#define DISP_COALESCE_AREA_COST 128
+#endif
+
+// Hook the refresh timer of `disp` so the invalid areas of each refresh are
+// merged before LVGL renders them.
+void disp_coalesce_init(lv_disp_t *disp);
+
+// lv_refr_now() for `disp` through the hooked timer: the invalid areas are
+// coalesced (and split for the scroll area) as in a timer-driven refresh.
+// lv_refr_now() itself calls LVGL's refresh directly and skips both.
+void disp_coalesce_refr_now(lv_disp_t *disp);
+
+// Number of area pairs merged during the last refresh.
+uint32_t disp_coalesce_last_merges(void);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef DISP_FLUSH_H
+#define DISP_FLUSH_H
+
+#include <lvgl.h>
+#include <stdint.h>
+
+// The ST7789 takes RGB565 big-endian and the flush DMA sends the draw buffer
+// bytes unchanged, so LVGL must render byte-swapped pixels. No swap happens
+// anywhere between the renderer and the wire.
+#if LV_COLOR_DEPTH != 16 || LV_COLOR_16_SWAP != 1
+#error "disp_flush needs LV_COLOR_DEPTH 16 and LV_COLOR_16_SWAP 1"
+#endif
+
+// Largest single EasyDMA transfer: TXD.MAXCNT is 16 bit on the nRF52840.
+// Rounded down to a whole number of RGB565 pixels.
+#define DISP_FLUSH_CHUNK_MAX 65534u
+
+// Byte mover behind the flush engine.
+// start() is called once per chunk; `first` is true for the first chunk of a
+// job, after which the pointer is expected to advance by itself (SPIM
+// ArrayList mode). The backend must call disp_flush_chunk_done() when the
+// chunk is on the wire, typically from its end-of-transfer interrupt.
+// finish() releases the bus after the last chunk.
+typedef struct {
+  void (*start)(const uint8_t *ptr, uint16_t len, bool first);
+  void (*finish)(void);
+} disp_flush_backend_t;
+
+// The device uses disp_bus_backend (SPIM3 EasyDMA, disp_bus.h).
+void disp_flush_init(const disp_flush_backend_t *backend);
+
+// Queue the pixel payload of one area. The address window must already be
+// set. Returns immediately; lv_disp_flush_ready() is signalled from the
+// completion of the last chunk.
+void disp_flush_start(lv_disp_drv_t *disp, const uint8_t *data, uint32_t bytes);
+
+// Backend completion hook (interrupt context).
+void disp_flush_chunk_done(void);
+
+// Hold the bus for a flush that disp_flush_start() will begin later. Until
+// then the flush counts as busy; disp_flush_wait() runs `start` to get it
+// going at once, so a panel command never waits on a flush nobody starts.
+// Main loop only.
+void disp_flush_reserve(void (*start)(void));
+
+bool disp_flush_busy(void);
+
+// Per-refresh flush counters, latched on the last flush of each refresh.
+typedef struct {
+  uint32_t areas; // address windows sent
+  uint32_t bytes; // pixel payload bytes sent
+} disp_flush_stats_t;
+
+void disp_flush_get_frame_stats(disp_flush_stats_t *out);
+
+// Block until the bus is free. Call before sending any other panel command.
+void disp_flush_wait(void);
+
+#endif
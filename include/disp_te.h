@@ -0,0 +1,73 @@
+#ifndef DISP_TE_H
+#define DISP_TE_H
+
+#include <lvgl.h>
+#include <stdint.h>
+
+// Tearing-effect synchronised presentation, selected with -D DISP_TE_MODE.
+// With the TE pin the first flush of every refresh is held until the panel's
+// next vertical blank (the TE interrupt only wakes the main loop, which
+// starts it from disp_te_service()), and LVGL's refresh period is
+// locked to a whole number of panel frames (the divisor), raised when frames
+// are missed and probed back down after a clean stretch.
+// The emulated mode has no vblank to sync to: it only paces the refresh
+// period against a timer at DISP_PANEL_HZ and flushes at once, so it still
+// tears.
+
+#define DISP_TE_OFF 0
+#define DISP_TE_PIN 1      // TE output wired to -D TFT_TE
+#define DISP_TE_EMULATED 2 // pacing only, timer at DISP_PANEL_HZ
+
+#ifndef DISP_TE_MODE
+#define DISP_TE_MODE DISP_TE_OFF
+#endif
+
+// Panel frame rate, programmed through FRCTRL2 (0x0F = 60 Hz)
+#define DISP_PANEL_HZ 60
+#define DISP_PANEL_FRCTRL2 0x0F
+
+#ifndef DISP_TE_MIN_DIV
+#define DISP_TE_MIN_DIV 1
+#endif
+#define DISP_TE_MAX_DIV 4
+
+typedef struct {
+  uint32_t frames;  // presented frames during animation
+  uint32_t janks;   // frames presented one or more panel frames late
+  uint32_t missed;  // panel frames missed in total
+  uint8_t divisor;  // current refresh period in panel frames
+} disp_te_stats_t;
+
+// Flushes one area: the flush_cb minus its wait for the bus
+typedef void (*disp_te_flush_t)(lv_disp_drv_t *drv, const lv_area_t *area,
+                                lv_color_t *color_p);
+
+#if DISP_TE_MODE != DISP_TE_OFF
+// After disp_bus_init(): programs the panel rate (and TE output) and takes
+// over the refresh period and wait_cb of `disp`. `flush` runs deferred
+// areas, in the main loop.
+void disp_te_init(lv_disp_t *disp, disp_te_flush_t flush);
+
+// Call from the flush_cb once the bus is idle. With the TE pin the first
+// area of a refresh is taken over: the bus is reserved, `flush` runs it from
+// disp_te_service() after the next TE edge and true is returned. Otherwise
+// the caller flushes now. LVGL waits for that area's flush_ready before the
+// next one, as usual, calling disp_te_service() from its wait_cb.
+bool disp_te_defer_flush(lv_disp_drv_t *drv, const lv_area_t *area,
+                         lv_color_t *color_p);
+
+// Start a deferred area once its edge has come. Call from loop().
+void disp_te_service(void);
+
+// Counters since the previous call
+void disp_te_get_stats(disp_te_stats_t *out);
+
+#define DISP_TE_DEFER_FLUSH(drv, area, color_p)                               \
+  disp_te_defer_flush(drv, area, color_p)
+#define DISP_TE_SERVICE() disp_te_service()
+#else
+#define DISP_TE_DEFER_FLUSH(drv, area, color_p) false
+#define DISP_TE_SERVICE() do {} while (0)
+#endif
+
+#endif
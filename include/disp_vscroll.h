@@ -0,0 +1,56 @@
+#ifndef DISP_VSCROLL_H
+#define DISP_VSCROLL_H
+
+#include <lvgl.h>
+#include <stdint.h>
+
+// Vertical scroll acceleration with the ST7789 scroll area (VSCRDEF /
+// VSCSAD). When the attached scroller (the tileview) moves vertically, the
+// panel's scroll start address is moved instead of re-sending the screen:
+// only the exposed strip is rendered, and every other dirty area is redrawn
+// at both its old and its shifted position. Panel rows are addressed
+// through disp_vscroll_row(), so an area never wraps inside a window.
+
+#ifndef DISP_VSCROLL
+#define DISP_VSCROLL 1
+#endif
+
+#if DISP_VSCROLL
+// After disp_coalesce_init() and latency_trace_attach() (chains their
+// rounder_cb). `scroller` must cover the whole screen; its scrollbar is
+// switched off since it would be shifted along with the content.
+void disp_vscroll_attach(lv_disp_t *disp, lv_obj_t *scroller);
+
+// Refresh timer, before and after the invalid areas are coalesced
+void disp_vscroll_prepare(lv_disp_t *disp);
+void disp_vscroll_split(lv_disp_t *disp);
+
+// Top of the flush_cb, after the vblank wait: moves the panel scroll
+// address on the first flush of a shifted refresh
+void disp_vscroll_before_flush(void);
+
+// Frame memory row (without the panel row offset) of screen row `y`
+uint16_t disp_vscroll_row(lv_coord_t y);
+
+// Back to the identity mapping (screen row y in frame row y), with the
+// whole screen invalidated; the panel follows on the next flush. Before
+// anything that addresses frame rows directly, such as a partial area.
+void disp_vscroll_reset(lv_disp_t *disp);
+
+// Refreshes that shifted the panel instead of redrawing it
+uint32_t disp_vscroll_shifts(void);
+
+#define DISP_VSCROLL_PREPARE(disp) disp_vscroll_prepare(disp)
+#define DISP_VSCROLL_SPLIT(disp) disp_vscroll_split(disp)
+#define DISP_VSCROLL_BEFORE_FLUSH() disp_vscroll_before_flush()
+#define DISP_VSCROLL_ROW(y) disp_vscroll_row(y)
+#define DISP_VSCROLL_RESET(disp) disp_vscroll_reset(disp)
+#else
+#define DISP_VSCROLL_PREPARE(disp) do {} while (0)
+#define DISP_VSCROLL_SPLIT(disp) do {} while (0)
+#define DISP_VSCROLL_BEFORE_FLUSH() do {} while (0)
+#define DISP_VSCROLL_ROW(y) (y)
+#define DISP_VSCROLL_RESET(disp) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include "touch_input.h"
+#include <lvgl.h>
+#include <stdint.h>
+
+// Flick recognition in front of LVGL's pointer input.
+// The first GESTURE_FLICK_MS of every stroke are held back. A stroke that
+// moves fast enough along one axis, or that the CST816S reports as a slide
+// when it ends, is a flick: it goes to the flick handler (which changes the
+// tile directly) and LVGL never sees it, so no drag-follow frames are
+// rendered. Taps and slow drags are replayed to LVGL unchanged.
+
+#ifndef GESTURE_FLICK_MS
+#define GESTURE_FLICK_MS 120 // 0: every stroke goes straight to LVGL
+#endif
+#define GESTURE_FLICK_MIN_PX 30     // travel along the main axis
+#define GESTURE_FLICK_PX_PER_S 600  // average speed over the stroke
+#define GESTURE_HOLD_DEPTH 16       // samples held while classifying
+
+// CST816S GestureID values
+#define CST816S_GESTURE_NONE 0x00
+#define CST816S_GESTURE_SLIDE_UP 0x01
+#define CST816S_GESTURE_SLIDE_DOWN 0x02
+#define CST816S_GESTURE_SLIDE_LEFT 0x03
+#define CST816S_GESTURE_SLIDE_RIGHT 0x04
+#define CST816S_GESTURE_SINGLE_CLICK 0x05
+#define CST816S_GESTURE_DOUBLE_CLICK 0x0B
+#define CST816S_GESTURE_LONG_PRESS 0x0C
+
+typedef struct {
+  lv_point_t point;
+  bool pressed;
+  uint32_t t_ms; // when the controller reported it
+} gesture_point_t;
+
+// `on_flick` receives the direction the finger moved in (LV_DIR_LEFT: the
+// finger went left). Returning false leaves the stroke to LVGL.
+void gesture_init(bool (*on_flick)(lv_dir_t dir));
+
+// Raw controller samples, oldest first
+void gesture_feed(const touch_sample_t *s);
+
+// Hand a held stroke to LVGL once its window has passed without samples,
+// and end a stroke that has been silent past TOUCH_RELEASE_TIMEOUT_MS
+// (a released point is queued if LVGL saw it pressed)
+void gesture_poll(uint32_t now_ms);
+
+// Points for the LVGL read_cb, oldest first
+bool gesture_pop(gesture_point_t *out);
+
+// Points queued or a stroke held back
+bool gesture_pending(void);
+
+// Flicks taken by the handler since boot
+uint32_t gesture_flicks(void);
+
+#endif
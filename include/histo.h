@@ -0,0 +1,23 @@
+#ifndef HISTO_H
+#define HISTO_H
+
+#include <stdint.h>
+
+// Percentiles over small sample sets (trace dumps, not hot paths).
+
+static inline void histo_sort(uint32_t *v, uint32_t n) {
+  for (uint32_t i = 1; i < n; i++) {
+    uint32_t x = v[i];
+    uint32_t j = i;
+    for (; j > 0 && v[j - 1] > x; j--)
+      v[j] = v[j - 1];
+    v[j] = x;
+  }
+}
+
+// `v` sorted, n > 0; nearest-rank below
+static inline uint32_t histo_pct(const uint32_t *v, uint32_t n, uint32_t p) {
+  return v[(n - 1) * p / 100];
+}
+
+#endif
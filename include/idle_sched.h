@@ -0,0 +1,38 @@
+#ifndef IDLE_SCHED_H
+#define IDLE_SCHED_H
+
+#include <stdint.h>
+
+// Sleep "forever" (until an interrupt calls idle_sched_wake_from_isr)
+#define IDLE_SLEEP_FOREVER 0xFFFFFFFFu
+
+// Rough nRF52840 figures (DCDC on, 64 MHz, code from cached flash) used to
+// turn the measured duty cycle into an average current estimate.
+#ifndef IDLE_RUN_CURRENT_UA
+#define IDLE_RUN_CURRENT_UA 3300
+#endif
+#ifndef IDLE_SLEEP_CURRENT_UA
+#define IDLE_SLEEP_CURRENT_UA 5
+#endif
+
+typedef struct {
+  uint32_t wakeups_per_s_x10; // average wakeups per second, x10
+  uint32_t duty_permille;     // fraction of time awake
+  uint32_t est_current_ua;    // CPU current estimate (backlight excluded)
+} idle_sched_stats_t;
+
+// Call once from setup() (i.e. from the loop task).
+void idle_sched_init(void);
+
+// Block the loop task for up to `max_ms`, or until an interrupt with work
+// for the main loop calls idle_sched_wake_from_isr(). The FreeRTOS tickless
+// idle hook puts the MCU to sleep for the whole period.
+void idle_sched_sleep(uint32_t max_ms);
+
+// Safe from any ISR at or below the FreeRTOS syscall priority.
+void idle_sched_wake_from_isr(void);
+
+// Statistics since the previous call.
+void idle_sched_get_stats(idle_sched_stats_t *out);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <lvgl.h>
+#include <stdint.h>
+
+// Touch-to-photon latency, enabled with -D LATENCY_TRACE.
+// One touch at a time is followed through the pipeline:
+//   IRQ     CST816S INT edge
+//   READ    sample delivered to LVGL by the read_cb
+//   EVENT   first LVGL input event dispatched for it (indev feedback_cb)
+//   INV     first area invalidated afterwards (disp rounder_cb)
+//   PHOTON  last flush of the next refresh has left the bus
+// A touch that never invalidates anything is dropped after
+// LATENCY_TRACE_STALE_US and the next INT starts a new chain.
+
+#define LATENCY_TRACE_DEPTH 64
+#define LATENCY_TRACE_STALE_US 250000
+
+typedef enum {
+  LAT_IRQ = 0,
+  LAT_READ,
+  LAT_EVENT,
+  LAT_INV,
+  LAT_PHOTON,
+  LAT_STAGES
+} lat_stage_t;
+
+#ifdef LATENCY_TRACE
+// Installs the indev feedback_cb and disp rounder_cb hooks (LVGL keeps
+// pointers to the drivers, so this works before or after registration)
+void latency_trace_attach(lv_disp_drv_t *disp, lv_indev_drv_t *indev);
+
+void latency_trace_irq(void); // interrupt context
+void latency_trace_read(void);
+void latency_trace_refr_begin(void);
+void latency_trace_flush_done(bool last); // interrupt context
+
+// Per-stage and end-to-end distributions over Serial
+void latency_trace_dump(void);
+
+#define LAT_TRACE_IRQ() latency_trace_irq()
+#define LAT_TRACE_READ() latency_trace_read()
+#define LAT_TRACE_REFR_BEGIN() latency_trace_refr_begin()
+#define LAT_TRACE_FLUSH_DONE(last) latency_trace_flush_done(last)
+#else
+#define LAT_TRACE_IRQ() do {} while (0)
+#define LAT_TRACE_READ() do {} while (0)
+#define LAT_TRACE_REFR_BEGIN() do {} while (0)
+#define LAT_TRACE_FLUSH_DONE(last) do {} while (0)
+#endif
+
+#endif
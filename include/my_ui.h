@@ -4,8 +4,56 @@
 #include <Arduino.h>
 #include <lvgl.h>
 
+// 1: blit pre-rendered hand sprites (tools/gen_hand_sprites.py) instead of
+// drawing lv_line hands
+#ifndef CLOCK_SPRITES
+#define CLOCK_SPRITES 0
+#endif
+
+// 1: build the detail/settings tiles when a scroll towards them begins
+#ifndef UI_LAZY_TILES
+#define UI_LAZY_TILES 1
+#endif
+
+// 1: draw the static detail tiles from an RLE snapshot while swiping
+#ifndef UI_TILE_CACHE
+#define UI_TILE_CACHE 1
+#endif
+
+// LVGL heap use above which tiles two hops away are torn down (0: always)
+#ifndef UI_TILE_MEM_BUDGET
+#define UI_TILE_MEM_BUDGET (LV_MEM_SIZE * 3 / 4)
+#endif
+
 void my_ui_init(void);
 
+// The swipe tileview (for disp_vscroll_attach())
+lv_obj_t *my_ui_tileview(void);
+
+// Animate to the tile a flick in finger direction `finger` leads to.
+// False when the current tile allows no scroll that way.
+bool my_ui_flick(lv_dir_t finger);
+
+// Column and row of the tile shown
+bool my_ui_tile_id(uint8_t *col, uint8_t *row);
+
+// Time spent in my_ui_init()
+uint32_t my_ui_init_us(void);
+
+// Always-on mode: second hand and data widgets hidden, hands stepping once
+// a minute, dashboard tile shown. `live` receives the screen area that is
+// still redrawn (the clock face).
+void my_ui_set_aod(bool on, lv_area_t *live);
+
+// Run the clock update now (RTC alarm fired)
+void my_ui_clock_tick(void);
+
+// Hand updates skipped because the endpoint pixel did not change
+uint32_t my_ui_clock_redraws_avoided(void);
+
+// Hand render time (us) and clock ticks since the previous call
+uint32_t my_ui_clock_render_us(uint32_t *ticks);
+
 // Call these from UI
 extern void update_user_brightness(int val);
 
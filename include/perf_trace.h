@@ -0,0 +1,52 @@
+#ifndef PERF_TRACE_H
+#define PERF_TRACE_H
+
+#include <stdint.h>
+
+// Per-refresh render/flush instrumentation, enabled with -D PERF_TRACE.
+// Timestamps come from the DWT cycle counter (64 MHz); records go to a fixed
+// ring and perf_trace_dump() prints p50/p95/p99 over Serial. Without
+// PERF_TRACE the hooks below expand to nothing.
+
+#define PERF_TRACE_DEPTH 128  // refreshes kept
+#define PERF_AREA_CMD_BYTES 11 // CASET + RASET + RAMWR per address window
+
+typedef struct {
+  uint32_t render_cyc; // refresh timer span minus time blocked on the bus
+  uint32_t flush_cyc;  // first flush start -> last flush complete
+  uint32_t px;         // pixels flushed
+  uint16_t areas;      // address windows
+  uint32_t spi_bytes;  // pixel payload + window commands
+} perf_trace_rec_t;
+
+#ifdef PERF_TRACE
+void perf_trace_init(void);
+uint32_t perf_cycles(void);
+
+void perf_trace_refr_begin(void);
+void perf_trace_refr_end(void);
+void perf_trace_flush_begin(uint32_t bytes, bool last);
+void perf_trace_flush_end(void); // interrupt context
+void perf_trace_wait(uint32_t cycles);
+
+// Histograms of the records currently in the ring
+void perf_trace_dump(void);
+
+#define PERF_TRACE_INIT() perf_trace_init()
+#define PERF_REFR_BEGIN() perf_trace_refr_begin()
+#define PERF_REFR_END() perf_trace_refr_end()
+#define PERF_FLUSH_BEGIN(bytes, last) perf_trace_flush_begin(bytes, last)
+#define PERF_FLUSH_END() perf_trace_flush_end()
+#define PERF_WAIT_BEGIN() uint32_t perf_wait_t0_ = perf_cycles()
+#define PERF_WAIT_END() perf_trace_wait(perf_cycles() - perf_wait_t0_)
+#else
+#define PERF_TRACE_INIT() do {} while (0)
+#define PERF_REFR_BEGIN() do {} while (0)
+#define PERF_REFR_END() do {} while (0)
+#define PERF_FLUSH_BEGIN(bytes, last) do {} while (0)
+#define PERF_FLUSH_END() do {} while (0)
+#define PERF_WAIT_BEGIN() do {} while (0)
+#define PERF_WAIT_END() do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <stdint.h>
+
+// Lock-free single-producer / single-consumer ring.
+// One side may run in interrupt context; no locking, no allocation.
+// N must be a power of two; the ring holds up to N elements.
+template <typename T, uint32_t N> class SpscRing {
+  static_assert(N != 0 && (N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+  // Producer side. Returns false (dropping `v`) when the ring is full.
+  bool push(const T &v) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == N)
+      return false;
+    buf[h & (N - 1)] = v;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false when the ring is empty.
+  bool pop(T &v) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) == t)
+      return false;
+    v = buf[t & (N - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return head.load(std::memory_order_acquire) ==
+           tail.load(std::memory_order_acquire);
+  }
+
+  uint32_t size() const {
+    return head.load(std::memory_order_acquire) -
+           tail.load(std::memory_order_acquire);
+  }
+
+private:
+  T buf[N];
+  std::atomic<uint32_t> head{0};
+  std::atomic<uint32_t> tail{0};
+};
+
+#endif
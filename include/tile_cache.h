@@ -0,0 +1,32 @@
+#ifndef TILE_CACHE_H
+#define TILE_CACHE_H
+
+#include <lvgl.h>
+#include <stdint.h>
+
+// Snapshot cache for static tiles.
+// A registered tile is rendered once, band by band, into an RLE RGB565
+// image on the system heap. Between tile_cache_begin() and tile_cache_end()
+// (a tileview scroll) its children are hidden and the image is blitted
+// instead, so every scroll frame costs one decode per row.
+
+#define TILE_CACHE_SLOTS 4
+#define TILE_CACHE_BAND_ROWS 16 // rows rendered per pass while snapshotting
+
+// Largest encoded image per tile; busier tiles stay live
+#ifndef TILE_CACHE_MAX_BYTES
+#define TILE_CACHE_MAX_BYTES (24 * 1024)
+#endif
+
+void tile_cache_enable(lv_obj_t *tile);
+
+// Content changed (or was deleted): the snapshot is retaken on next use
+void tile_cache_invalidate(lv_obj_t *tile);
+
+void tile_cache_begin(void);
+void tile_cache_end(void);
+
+// Encoded bytes held by all snapshots
+uint32_t tile_cache_bytes(void);
+
+#endif
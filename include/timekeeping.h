@@ -0,0 +1,50 @@
+#ifndef TIMEKEEPING_H
+#define TIMEKEEPING_H
+
+#include <stdint.h>
+
+// Wall clock on the 32.768 kHz RTC (LFCLK).
+// Epoch time in UTC seconds; the local time adds a fixed zone offset and an
+// optional daylight saving rule.
+
+#define TK_RTC_HZ 8 // RTC2 prescaler 4095: 125 ms resolution, 24 day wrap
+
+typedef enum {
+  TK_DST_NONE = 0,
+  TK_DST_EU = 1, // last Sun Mar 01:00 UTC .. last Sun Oct 01:00 UTC
+  TK_DST_US = 2, // 2nd Sun Mar 02:00 local .. 1st Sun Nov 02:00 local
+} tk_dst_rule_t;
+
+void timekeeping_init(uint32_t epoch);
+
+// UTC seconds; `ms` (may be NULL) receives the sub-second part
+uint32_t timekeeping_now(uint16_t *ms);
+void timekeeping_set(uint32_t epoch);
+
+void timekeeping_set_zone(int16_t offset_min, tk_dst_rule_t rule);
+
+// Local offset from UTC in seconds (zone + DST) at a given instant
+int32_t timekeeping_local_offset(uint32_t epoch);
+
+// Local time as seconds since 1970-01-01 00:00 local
+uint32_t timekeeping_local(uint16_t *ms);
+
+// Raise the alarm at UTC second `epoch` (RTC compare, wakes the MCU).
+// Replaces any previously armed alarm.
+void timekeeping_arm(uint32_t epoch);
+
+// True once per fired alarm (main loop side)
+bool timekeeping_take_alarm(void);
+
+// Serial commands (one line, without the terminator):
+//   T<epoch>           set UTC time (digits must follow the T)
+//   Z<minutes>[,rule]  zone offset and tk_dst_rule_t
+// Returns false if the line is not a timekeeping command.
+bool timekeeping_command(const char *line);
+
+#if !defined(NRF52840_XXAA)
+// Host builds run on a fake RTC that only moves when told to
+void timekeeping_fake_advance_ms(uint32_t ms);
+#endif
+
+#endif
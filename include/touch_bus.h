@@ -0,0 +1,41 @@
+#ifndef TOUCH_BUS_H
+#define TOUCH_BUS_H
+
+#include <stdint.h>
+
+// CST816S register burst on TWIM0 with EasyDMA, selected with
+// -D TOUCH_BUS_DMA. The INT edge's GPIOTE event starts the transfer through
+// a PPI channel: register address, repeated start, the burst and stop run
+// in hardware at 400 kHz, and the CPU only collects the bytes.
+
+#define TOUCH_BUS_HZ 400000
+#define TOUCH_BUS_MAX_LEN 8
+
+// The PPI channel is the highest programmable one nobody has configured
+// (disabled, no endpoints). With the SoftDevice enabled PPI channels must
+// come from sd_ppi_* instead.
+#define TOUCH_BUS_PPI_CHANNELS 20 // programmable; 20-31 are fixed
+
+#ifdef TOUCH_BUS_DMA
+// Claim TWIM0 on the given pins once the controller is initialised
+// (touch.begin(); Wire.end();).
+void touch_bus_init(uint8_t sda, uint8_t scl);
+
+// Start a read of `len` bytes from `reg` of `addr` on every edge of
+// `int_pin`. The pin interrupt must already be attached, as its GPIOTE
+// channel provides the event. False if it is not or no PPI channel is free;
+// call touch_bus_end() and read over Wire then.
+bool touch_bus_arm(uint8_t int_pin, uint8_t addr, uint8_t reg, uint8_t len);
+
+// Bytes of the burst started by the last edge: 1 copied to `out`, 0 still
+// on the bus, -1 bus error (NACK, controller asleep)
+int touch_bus_take(uint8_t *out);
+
+// Stop a burst that never completed, so the next edge starts from idle
+void touch_bus_abort(void);
+
+// Give TWIM0 back (for Wire.begin())
+void touch_bus_end(void);
+#endif
+
+#endif
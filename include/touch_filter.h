@@ -0,0 +1,73 @@
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#include <lvgl.h>
+#include <stdint.h>
+
+// Pointer smoothing and prediction between the flick recognizer and LVGL.
+// A 1-euro filter (Casiez et al.) removes the controller's jitter: a low
+// cutoff while the finger rests, rising with speed so that drags do not
+// lag. The smoothed point is then moved ahead along the filtered velocity
+// to when the next refresh will show it, which also makes up for the
+// filter's own delay. Configs are per screen; -D TOUCH_FILTER=0 feeds LVGL
+// the raw points.
+
+#ifndef TOUCH_FILTER
+#define TOUCH_FILTER 1
+#endif
+
+// Render and flush time of a drag frame: the point is shown this long
+// after the refresh starts
+#define TOUCH_FILTER_LEAD_MS 8
+#define TOUCH_FILTER_SCREENS 4
+
+typedef struct {
+  float min_cutoff_hz;     // cutoff with the finger at rest
+  float beta;              // cutoff rise per px/s of speed
+  float d_cutoff_hz;       // smoothing of the speed estimate
+  uint16_t predict_max_ms; // furthest look-ahead, 0 for none
+} touch_filter_cfg_t;
+
+// Smoothing only, for screens without a config of their own
+#define TOUCH_FILTER_CFG_DEFAULT {1.5f, 0.3f, 1.0f, 0}
+// Drags: smoothing plus prediction to the frame
+#define TOUCH_FILTER_CFG_DRAG {1.5f, 0.3f, 1.0f, 40}
+
+typedef struct {
+  float x, y;        // smoothed position
+  float dx, dy;      // smoothed velocity, px/ms
+  float lag_ms;      // delay of the last smoothing step
+  uint32_t t_ms;     // time of the last sample
+  uint32_t ahead_ms; // look-ahead used for the last point
+  bool primed;
+} touch_filter_t;
+
+// Use `cfg` (copied) while `scr` is the active screen; NULL `cfg` drops
+// the screen's entry
+void touch_filter_set_config(lv_obj_t *scr, const touch_filter_cfg_t *cfg);
+
+// Config of the active screen
+const touch_filter_cfg_t *touch_filter_config(void);
+
+void touch_filter_reset(touch_filter_t *f);
+
+// Add a sample taken at `t_ms`
+void touch_filter_update(touch_filter_t *f, const touch_filter_cfg_t *cfg,
+                         lv_coord_t x, lv_coord_t y, uint32_t t_ms);
+
+// Smoothed position `ahead_ms` after the last sample, capped at the
+// config's look-ahead
+lv_point_t touch_filter_predict(const touch_filter_t *f,
+                                const touch_filter_cfg_t *cfg,
+                                uint32_t ahead_ms);
+
+// Time from a sample taken `age_ms` ago to the moment the next refresh of
+// the default display shows it
+uint32_t touch_filter_ahead_ms(uint32_t age_ms);
+
+// Replace `p` with what LVGL should see: the filtered, predicted point
+// while pressed; the raw point (and a reset) on release
+void touch_filter_apply(touch_filter_t *f, lv_point_t *p, bool pressed,
+                        uint32_t t_ms, uint32_t now_ms);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef TOUCH_INDEV_H
+#define TOUCH_INDEV_H
+
+#include <lvgl.h>
+
+// LVGL pointer read_cb over the touch_input ring. Every raw sample goes
+// through the flick recognizer (gesture.h), which decides what LVGL gets to
+// see, then through touch_filter.h. A press stays latched between INT
+// pulses until a release arrives or the recognizer times the stroke out
+// (TOUCH_RELEASE_TIMEOUT_MS).
+// Released with nothing buffered or held, the read pauses its own timer;
+// resume it when touch_input_available() turns true.
+
+// `on_press` runs for every sample with a finger down (display wake-up,
+// idle timer); may be NULL
+void touch_indev_init(void (*on_press)(void));
+
+void touch_indev_read(lv_indev_drv_t *drv, lv_indev_data_t *data);
+
+#endif
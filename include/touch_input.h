@@ -0,0 +1,55 @@
+#ifndef TOUCH_INPUT_H
+#define TOUCH_INPUT_H
+
+#include <lvgl.h>
+#include <stdint.h>
+
+// CST816S event field (upper bits of XposH)
+#define TOUCH_EVENT_DOWN 0
+#define TOUCH_EVENT_UP 1
+#define TOUCH_EVENT_CONTACT 2
+
+// The controller reports while a finger is down, so a silent INT line for
+// this long means the UP was lost
+#define TOUCH_RELEASE_TIMEOUT_MS 150
+
+typedef struct {
+  uint16_t x;
+  uint16_t y;
+  uint8_t gesture; // CST816S GestureID register
+  uint8_t fingers; // 0 or 1
+  uint8_t event;   // TOUCH_EVENT_*
+  uint32_t t_ms;   // millis() when the sample was read
+} touch_sample_t;
+
+typedef struct {
+  uint32_t samples;
+  uint32_t errors;       // NACKs and timed-out bursts
+  uint32_t cpu_us_sum;   // main loop time spent reading
+  uint32_t cpu_us_max;
+  uint32_t ready_us_sum; // INT edge -> sample in hand
+  uint32_t ready_us_max;
+  bool dma; // reads come from the TWIM burst (touch_bus.h), else Wire
+} touch_bus_stats_t;
+
+// Attach the INT edge handler. Call after the controller has been reset.
+void touch_input_init(uint8_t int_pin);
+
+// Producer: fetch a sample from the controller if INT fired since the last
+// call. Cheap no-op otherwise (no I2C traffic).
+void touch_input_service(void);
+
+// True while an INT edge is waiting to be serviced.
+bool touch_input_irq_pending(void);
+
+// Consumer side of the sample ring.
+bool touch_input_pop(touch_sample_t *out);
+bool touch_input_available(void);
+
+// Samples lost because the ring was full.
+uint32_t touch_input_dropped(void);
+
+// Read costs since the previous call
+void touch_input_get_bus_stats(touch_bus_stats_t *out);
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef TRIG_Q15_H
+#define TRIG_Q15_H
+
+#include <stdint.h>
+
+// Fixed-point sine/cosine for UI geometry.
+// Angles are integer tenths of a degree (3600 per turn), results are Q15
+// (32767 == 1.0). A quarter-wave table with one entry per degree is built at
+// compile time; tenths are linearly interpolated (max error ~2 LSB, far
+// below one pixel for any hand length on this screen).
+
+#define TRIG_Q15_ONE 32767
+#define TRIG_TURN 3600 // tenths of a degree per full turn
+
+namespace trig_q15_detail {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Taylor series, accurate to ~1e-12 on [0, pi/2]
+constexpr double sin_taylor(double x) {
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 12; n++) {
+    term *= -x * x / ((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+struct QuarterTable {
+  int16_t v[91]; // sin(0..90 deg)
+};
+
+constexpr QuarterTable make_quarter_table() {
+  QuarterTable t{};
+  for (int i = 0; i <= 90; i++)
+    t.v[i] = (int16_t)(sin_taylor(i * kPi / 180.0) * TRIG_Q15_ONE + 0.5);
+  return t;
+}
+
+inline constexpr QuarterTable quarter = make_quarter_table();
+
+static_assert(quarter.v[0] == 0, "sin(0)");
+static_assert(quarter.v[30] >= 16383 && quarter.v[30] <= 16384, "sin(30 deg)");
+static_assert(quarter.v[90] == TRIG_Q15_ONE, "sin(90 deg)");
+
+// sin() for 0..900 tenths
+constexpr int16_t sin_quarter(int32_t a) {
+  int32_t i = a / 10;
+  int32_t f = a % 10;
+  if (f == 0)
+    return quarter.v[i];
+  return (int16_t)(quarter.v[i] + ((quarter.v[i + 1] - quarter.v[i]) * f + 5) / 10);
+}
+
+} // namespace trig_q15_detail
+
+constexpr int16_t sin_q15(int32_t a) {
+  a %= TRIG_TURN;
+  if (a < 0)
+    a += TRIG_TURN;
+  if (a <= 900)
+    return trig_q15_detail::sin_quarter(a);
+  if (a <= 1800)
+    return trig_q15_detail::sin_quarter(1800 - a);
+  if (a <= 2700)
+    return -trig_q15_detail::sin_quarter(a - 1800);
+  return -trig_q15_detail::sin_quarter(TRIG_TURN - a);
+}
+
+constexpr int16_t cos_q15(int32_t a) { return sin_q15(a + 900); }
+
+// Round(v * len) for a Q15 factor
+constexpr int32_t mul_q15(int16_t v, int32_t len) {
+  return (v * len + (1 << 14)) >> 15;
+}
+
+static_assert(sin_q15(2700) == -TRIG_Q15_ONE, "sin(270 deg)");
+static_assert(cos_q15(1800) == -TRIG_Q15_ONE, "cos(180 deg)");
+static_assert(mul_q15(cos_q15(600), 100) == 50, "cos(60 deg) * 100");
+
+#endif
@@ -0,0 +1,179 @@
+#include "backlight.h"
+#include "idle_sched.h"
+#include <Arduino.h>
+#include <HardwarePWM.h>
+#include <math.h>
+
+// Backlight fades played by the nRF52 PWM peripheral.
+// A fade is a gamma-corrected ramp of duty values in RAM; the PWM reads it
+// through EasyDMA, holds each entry for BACKLIGHT_STEP_MS and keeps the last
+// value when the sequence ends. SEQEND raises an interrupt that only flags
+// completion, the callback itself runs on the main loop.
+//
+// The instance is reserved through the core's HardwarePWM ownership, which
+// analogWrite(), tone() and Servo respect. If something already runs it,
+// the backlight is only switched on and off.
+
+#define BL_PWM NRF_PWM3
+#define BL_HWPWM HwPWM3
+#define BL_PWM_TOKEN 0x4C4B4342UL // "BCKL"
+#define BL_PWM_IRQn PWM3_IRQn
+#define BL_PWM_IRQHandler PWM3_IRQHandler
+
+#define BL_PWM_TOP 255       // 1 MHz / 256 = 3.9 kHz PWM
+#define BL_PWM_PERIOD_US 256 // one PWM period at 1 MHz
+#define BL_MAX_STEPS 64
+
+// Two ramps so a retarget never rewrites the one being played
+static uint16_t ramp[2][BL_MAX_STEPS];
+static uint8_t ramp_level[2][BL_MAX_STEPS]; // perceptual level per entry
+static uint8_t ramp_len = 1;
+static uint8_t ramp_cur = 0;
+static uint32_t ramp_start_ms = 0;
+
+static bool owned = false; // BL_PWM is ours
+static uint8_t bl_pin;
+static uint16_t polarity = 0;
+static uint8_t end_level = 0;
+static volatile bool fading = false;
+static volatile bool done_pending = false;
+static backlight_done_cb_t done_cb = NULL;
+
+static uint16_t gamma_duty(uint8_t level) {
+  float v = powf(level / 255.0f, BACKLIGHT_GAMMA) * BL_PWM_TOP;
+  uint16_t duty = (uint16_t)(v + 0.5f);
+  if (level > 0 && duty == 0)
+    duty = 1; // lowest level still lights up
+  return duty | polarity;
+}
+
+// Mute SEQEND while a new ramp is prepared: the one being replaced may end
+// at any moment and must not complete the new one.
+static void pwm_hold(void) {
+  NVIC_DisableIRQ(BL_PWM_IRQn);
+  BL_PWM->EVENTS_SEQEND[0] = 0;
+}
+
+// SEQSTART reloads the PWM on the fly, so a running ramp is replaced without
+// stopping the output. The SEQEND of the replaced ramp is discarded. Call
+// after pwm_hold().
+static void pwm_play(const uint16_t *seq, uint8_t len) {
+  BL_PWM->SEQ[0].PTR = (uint32_t)seq;
+  BL_PWM->SEQ[0].CNT = len;
+  BL_PWM->TASKS_SEQSTART[0] = 1;
+  BL_PWM->EVENTS_SEQEND[0] = 0;
+  NVIC_ClearPendingIRQ(BL_PWM_IRQn);
+  NVIC_EnableIRQ(BL_PWM_IRQn);
+}
+
+extern "C" void BL_PWM_IRQHandler(void) {
+  if (BL_PWM->EVENTS_SEQEND[0]) {
+    BL_PWM->EVENTS_SEQEND[0] = 0;
+    (void)BL_PWM->EVENTS_SEQEND[0];
+    if (fading) {
+      fading = false;
+      done_pending = true;
+      idle_sched_wake_from_isr();
+    }
+  }
+}
+
+bool backlight_init(uint8_t pin, bool active_high) {
+  // Sequence values with bit 15 set start the period high (duty = value)
+  polarity = active_high ? 0x8000 : 0;
+  bl_pin = pin;
+
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, active_high ? LOW : HIGH);
+
+  // Fails if the instance is owned, enabled or has pins connected
+  owned = BL_HWPWM.takeOwnership(BL_PWM_TOKEN);
+  if (!owned)
+    return false;
+
+  BL_PWM->PSEL.OUT[0] = g_ADigitalPinMap[pin];
+  for (int ch = 1; ch < 4; ch++)
+    BL_PWM->PSEL.OUT[ch] = 0xFFFFFFFFUL; // disconnected
+  BL_PWM->MODE = PWM_MODE_UPDOWN_Up << PWM_MODE_UPDOWN_Pos;
+  BL_PWM->PRESCALER = PWM_PRESCALER_PRESCALER_DIV_16
+                      << PWM_PRESCALER_PRESCALER_Pos;
+  BL_PWM->COUNTERTOP = BL_PWM_TOP;
+  BL_PWM->LOOP = 0;
+  BL_PWM->DECODER = (PWM_DECODER_LOAD_Common << PWM_DECODER_LOAD_Pos) |
+                    (PWM_DECODER_MODE_RefreshCount << PWM_DECODER_MODE_Pos);
+  BL_PWM->SEQ[0].REFRESH = BACKLIGHT_STEP_MS * 1000 / BL_PWM_PERIOD_US - 1;
+  BL_PWM->SEQ[0].ENDDELAY = 0;
+  BL_PWM->ENABLE = PWM_ENABLE_ENABLE_Enabled << PWM_ENABLE_ENABLE_Pos;
+
+  BL_PWM->INTENSET = PWM_INTENSET_SEQEND0_Msk;
+  NVIC_ClearPendingIRQ(BL_PWM_IRQn);
+  NVIC_SetPriority(BL_PWM_IRQn, 6);
+  NVIC_EnableIRQ(BL_PWM_IRQn);
+
+  backlight_set(0);
+  return true;
+}
+
+uint8_t backlight_level(void) {
+  if (!fading)
+    return end_level;
+  uint32_t step = (millis() - ramp_start_ms) / BACKLIGHT_STEP_MS;
+  if (step >= ramp_len)
+    step = ramp_len - 1;
+  return ramp_level[ramp_cur][step];
+}
+
+bool backlight_fading(void) { return fading; }
+
+void backlight_set(uint8_t level) { backlight_fade_to(level, 0, NULL); }
+
+void backlight_fade_to(uint8_t level, uint16_t ms, backlight_done_cb_t cb) {
+  uint8_t from = backlight_level();
+
+  if (owned)
+    pwm_hold();
+  fading = false;
+  done_pending = false; // a cancelled fade does not report completion
+
+  if (!owned) {
+    // No PWM: on or off at once, completion on the next service
+    bool on = level > 0;
+    digitalWrite(bl_pin, on == (polarity != 0) ? HIGH : LOW);
+    end_level = level;
+    done_cb = cb;
+    done_pending = true;
+    return;
+  }
+
+  uint8_t buf = ramp_cur ^ 1;
+  uint32_t steps = ms / BACKLIGHT_STEP_MS;
+  if (steps < 1)
+    steps = 1;
+  if (steps > BL_MAX_STEPS)
+    steps = BL_MAX_STEPS;
+
+  // Linear in perceptual space, i.e. gamma-shaped in duty
+  for (uint32_t i = 0; i < steps; i++) {
+    int l = from + ((int)level - from) * (int)(i + 1) / (int)steps;
+    ramp_level[buf][i] = (uint8_t)l;
+    ramp[buf][i] = gamma_duty((uint8_t)l);
+  }
+
+  ramp_cur = buf;
+  ramp_len = (uint8_t)steps;
+  ramp_start_ms = millis();
+  end_level = level;
+  done_cb = cb;
+  fading = true;
+  pwm_play(ramp[buf], ramp_len);
+}
+
+void backlight_service(void) {
+  if (!done_pending)
+    return;
+  done_pending = false;
+  backlight_done_cb_t cb = done_cb;
+  done_cb = NULL;
+  if (cb)
+    cb();
+}
@@ -0,0 +1,135 @@
+#include "clock_sprites.h"
+#include <Arduino.h>
+
+// Clock hands blitted from pre-rendered A4 sprites.
+// The face object draws the hands itself at LV_EVENT_DRAW_MAIN_END by
+// alpha-blending sprite pixels straight into the draw buffer, so a tick
+// costs one small rectangle per moved hand instead of the software line
+// renderer with round caps.
+
+static clock_sprite_hand_t *hands = NULL;
+static uint8_t hand_count = 0;
+static uint32_t render_us = 0;
+
+// Sprite rectangle of `hand` in absolute coordinates.
+static bool sprite_area(const lv_obj_t *face, const clock_sprite_hand_t *hand,
+                        lv_area_t *out) {
+  if (hand->pos < 0)
+    return false;
+
+  const clock_sprite_set_t *set = hand->set;
+  uint16_t q = hand->pos / set->stored;
+  const clock_sprite_frame_t *f = &set->frames[hand->pos % set->stored];
+  lv_coord_t cx = face->coords.x1 + lv_area_get_width(&face->coords) / 2;
+  lv_coord_t cy = face->coords.y1 + lv_area_get_height(&face->coords) / 2;
+  lv_coord_t w = f->w;
+  lv_coord_t h = f->h;
+
+  // Quarter turns clockwise about the pivot (screen y points down)
+  switch (q) {
+  case 0:
+    out->x1 = cx + f->x;
+    out->y1 = cy + f->y;
+    break;
+  case 1: // (x, y) -> (-y, x)
+    out->x1 = cx - (f->y + h - 1);
+    out->y1 = cy + f->x;
+    w = f->h;
+    h = f->w;
+    break;
+  case 2: // (x, y) -> (-x, -y)
+    out->x1 = cx - (f->x + w - 1);
+    out->y1 = cy - (f->y + h - 1);
+    break;
+  default: // (x, y) -> (y, -x)
+    out->x1 = cx + f->y;
+    out->y1 = cy - (f->x + w - 1);
+    w = f->h;
+    h = f->w;
+    break;
+  }
+  out->x2 = out->x1 + w - 1;
+  out->y2 = out->y1 + h - 1;
+  return true;
+}
+
+static void blit_hand(lv_draw_ctx_t *draw_ctx, const lv_obj_t *face,
+                      const clock_sprite_hand_t *hand) {
+  lv_area_t area;
+  if (!sprite_area(face, hand, &area))
+    return;
+
+  lv_area_t clip;
+  if (!_lv_area_intersect(&clip, &area, draw_ctx->clip_area))
+    return;
+
+  const clock_sprite_set_t *set = hand->set;
+  uint16_t q = hand->pos / set->stored;
+  const clock_sprite_frame_t *f = &set->frames[hand->pos % set->stored];
+  const uint8_t *data = set->data + f->offset;
+  int32_t stride = (f->w + 1) / 2;
+
+  // Destination offset from the pivot -> source offset: (sx, sy) =
+  // (mxx * dx + mxy * dy, myx * dx + myy * dy), inverse of the quarter turn
+  static const int8_t inv[4][4] = {
+      {1, 0, 0, 1}, {0, 1, -1, 0}, {-1, 0, 0, -1}, {0, -1, 1, 0}};
+  int32_t mxx = inv[q][0], mxy = inv[q][1], myx = inv[q][2], myy = inv[q][3];
+
+  lv_coord_t cx = face->coords.x1 + lv_area_get_width(&face->coords) / 2;
+  lv_coord_t cy = face->coords.y1 + lv_area_get_height(&face->coords) / 2;
+  lv_color_t *buf = (lv_color_t *)draw_ctx->buf;
+  int32_t buf_w = lv_area_get_width(draw_ctx->buf_area);
+
+  for (lv_coord_t y = clip.y1; y <= clip.y2; y++) {
+    lv_color_t *dst = buf + (y - draw_ctx->buf_area->y1) * buf_w +
+                      (clip.x1 - draw_ctx->buf_area->x1);
+    int32_t dx = clip.x1 - cx;
+    int32_t dy = y - cy;
+    int32_t sx = mxx * dx + mxy * dy - f->x;
+    int32_t sy = myx * dx + myy * dy - f->y;
+
+    for (lv_coord_t x = clip.x1; x <= clip.x2; x++, dst++) {
+      uint8_t b = data[sy * stride + (sx >> 1)];
+      uint8_t a = (sx & 1) ? (b & 0x0F) : (b >> 4);
+      if (a == 15)
+        *dst = hand->color;
+      else if (a != 0)
+        *dst = lv_color_mix(hand->color, *dst, a * 17);
+      sx += mxx;
+      sy += myx;
+    }
+  }
+}
+
+static void face_draw_cb(lv_event_t *e) {
+  lv_obj_t *face = lv_event_get_target(e);
+  lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+
+  uint32_t t0 = micros();
+  for (uint8_t i = 0; i < hand_count; i++)
+    blit_hand(draw_ctx, face, &hands[i]);
+  render_us += micros() - t0;
+}
+
+void clock_sprites_attach(lv_obj_t *face, clock_sprite_hand_t *h,
+                          uint8_t count) {
+  hands = h;
+  hand_count = count;
+  lv_obj_add_event_cb(face, face_draw_cb, LV_EVENT_DRAW_MAIN_END, NULL);
+}
+
+bool clock_sprites_set(lv_obj_t *face, clock_sprite_hand_t *hand,
+                       int16_t pos) {
+  if (hand->pos == pos)
+    return false;
+
+  lv_area_t a;
+  if (sprite_area(face, hand, &a))
+    lv_obj_invalidate_area(face, &a);
+  hand->pos = pos;
+  if (sprite_area(face, hand, &a))
+    lv_obj_invalidate_area(face, &a);
+  return true;
+}
+
+uint32_t clock_sprites_render_us(void) { return render_us; }
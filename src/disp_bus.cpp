@@ -0,0 +1,184 @@
+#include "disp_bus.h"
+#include <Arduino.h>
+
+// Commands and address windows are short blocking transfers polled on
+// EVENTS_END; pixel payloads are EasyDMA ArrayList chains completed from the
+// END interrupt (see disp_flush.cpp). INTEN.END is only set while a pixel
+// job owns the bus, so the polled transfers never reach the ISR.
+
+#define BUS NRF_SPIM3
+#define BUS_IRQn SPIM3_IRQn
+#define BUS_IRQHandler SPIM3_IRQHandler
+
+#define ST7789_CASET 0x2A
+#define ST7789_RASET 0x2B
+#define ST7789_RAMWR 0x2C
+
+// Errata 198: SPIM3 reads stale data when the CPU or another EasyDMA
+// master accesses the RAM block it transmits from. Giving SPIM3 priority
+// on the blocks it reads (nrfx's workaround) avoids it.
+#define ERRATA_198_REG (*(volatile uint32_t *)0x40000E00)
+#define RAM_BLOCK_SIZE 0x2000 // AHB slaves 0-7: 8 KB each, 8: the rest
+#define RAM_BLOCKS_END 0x20010000
+
+static uint8_t cmd_buf[16]; // EasyDMA source for commands
+static volatile bool job = false;
+static uint32_t errata_198_saved;
+
+// RAM block priority bits for [ptr, ptr + len)
+static uint32_t ram_blocks(const uint8_t *ptr, uint32_t len) {
+  uint32_t addr = (uint32_t)ptr & ~(RAM_BLOCK_SIZE - 1);
+  uint32_t end = (uint32_t)ptr + len;
+  uint32_t mask = 0;
+  for (; addr < end; addr += RAM_BLOCK_SIZE) {
+    if (addr >= RAM_BLOCKS_END)
+      return mask | (1UL << 8);
+    mask |= 1UL << ((addr >> 13) & 0x7);
+  }
+  return mask;
+}
+
+static void xfer(const uint8_t *ptr, uint16_t len, uint8_t cmd_bytes) {
+  errata_198_saved = ERRATA_198_REG;
+  ERRATA_198_REG = ram_blocks(ptr, len);
+  BUS->DCXCNT = cmd_bytes; // DC low for the first `cmd_bytes` bytes
+  BUS->TXD.PTR = (uint32_t)ptr;
+  BUS->TXD.MAXCNT = len;
+  BUS->EVENTS_END = 0;
+  BUS->TASKS_START = 1;
+  while (!BUS->EVENTS_END) {
+  }
+  BUS->EVENTS_END = 0;
+  ERRATA_198_REG = errata_198_saved;
+}
+
+// SCK and MOSI toggle at up to 32 MHz: standard drive rounds the edges off
+static void high_drive(uint32_t pin) {
+  NRF_GPIO_Type *port = pin < 32 ? NRF_P0 : NRF_P1;
+  uint32_t cnf = port->PIN_CNF[pin & 31] & ~GPIO_PIN_CNF_DRIVE_Msk;
+  port->PIN_CNF[pin & 31] =
+      cnf | (GPIO_PIN_CNF_DRIVE_H0H1 << GPIO_PIN_CNF_DRIVE_Pos);
+}
+
+void disp_bus_set_freq(uint32_t hz) {
+  if (hz >= 32000000)
+    BUS->FREQUENCY = SPIM_FREQUENCY_FREQUENCY_M32;
+  else if (hz >= 16000000)
+    BUS->FREQUENCY = SPIM_FREQUENCY_FREQUENCY_M16;
+  else
+    BUS->FREQUENCY = SPIM_FREQUENCY_FREQUENCY_M8;
+}
+
+void disp_bus_init(uint32_t hz) {
+  BUS->ENABLE = SPIM_ENABLE_ENABLE_Disabled << SPIM_ENABLE_ENABLE_Pos;
+
+  // SPIM outputs must also be GPIO outputs, idle levels first
+  digitalWrite(TFT_CS, HIGH);
+  pinMode(TFT_CS, OUTPUT);
+  pinMode(TFT_DC, OUTPUT);
+  digitalWrite(TFT_SCLK, LOW);
+  pinMode(TFT_SCLK, OUTPUT);
+  pinMode(TFT_MOSI, OUTPUT);
+  high_drive(g_ADigitalPinMap[TFT_SCLK]);
+  high_drive(g_ADigitalPinMap[TFT_MOSI]);
+
+  BUS->PSEL.SCK = g_ADigitalPinMap[TFT_SCLK];
+  BUS->PSEL.MOSI = g_ADigitalPinMap[TFT_MOSI];
+  BUS->PSEL.MISO = SPIM_PSEL_MISO_CONNECT_Disconnected
+                   << SPIM_PSEL_MISO_CONNECT_Pos;
+  BUS->PSEL.CSN = g_ADigitalPinMap[TFT_CS];
+  BUS->PSELDCX = g_ADigitalPinMap[TFT_DC];
+  BUS->CSNPOL = SPIM_CSNPOL_CSNPOL_LOW << SPIM_CSNPOL_CSNPOL_Pos;
+  BUS->IFTIMING.CSNDUR = 2;  // 2 x 15.625 ns CS setup/hold
+  BUS->CONFIG = 0;           // mode 0, MSB first
+  BUS->ORC = 0;
+  BUS->RXD.MAXCNT = 0;
+  BUS->RXD.LIST = 0;
+  BUS->TXD.LIST = 0;
+  BUS->INTENCLR = 0xFFFFFFFF;
+  disp_bus_set_freq(hz);
+
+  NVIC_ClearPendingIRQ(BUS_IRQn);
+  NVIC_SetPriority(BUS_IRQn, 3);
+  NVIC_EnableIRQ(BUS_IRQn);
+
+  disp_bus_enable(true);
+}
+
+void disp_bus_enable(bool on) {
+  if (on) {
+    BUS->ENABLE = SPIM_ENABLE_ENABLE_Enabled << SPIM_ENABLE_ENABLE_Pos;
+    return;
+  }
+  BUS->ENABLE = SPIM_ENABLE_ENABLE_Disabled << SPIM_ENABLE_ENABLE_Pos;
+  // Errata 195: SPIM3 keeps drawing current after being disabled
+  *(volatile uint32_t *)0x4002F004 = 1;
+}
+
+void disp_bus_command(uint8_t cmd, const uint8_t *data, uint8_t len) {
+  if (len > sizeof(cmd_buf) - 1)
+    len = sizeof(cmd_buf) - 1;
+  cmd_buf[0] = cmd;
+  memcpy(cmd_buf + 1, data, len);
+  xfer(cmd_buf, 1 + len, 1);
+}
+
+static void send_range(uint8_t cmd, uint16_t a, uint16_t b) {
+  uint8_t d[4] = {(uint8_t)(a >> 8), (uint8_t)a, (uint8_t)(b >> 8),
+                  (uint8_t)b};
+  disp_bus_command(cmd, d, sizeof(d));
+}
+
+void disp_bus_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
+  send_range(ST7789_CASET, x1 + DISP_BUS_COL_OFFSET, x2 + DISP_BUS_COL_OFFSET);
+  send_range(ST7789_RASET, y1 + DISP_BUS_ROW_OFFSET, y2 + DISP_BUS_ROW_OFFSET);
+  disp_bus_command(ST7789_RAMWR, NULL, 0);
+}
+
+void disp_bus_write(const uint8_t *data, uint32_t len) {
+  while (len > 0) {
+    uint16_t n = (len > DISP_FLUSH_CHUNK_MAX) ? DISP_FLUSH_CHUNK_MAX : len;
+    xfer(data, n, 0);
+    data += n;
+    len -= n;
+  }
+}
+
+static void bus_start(const uint8_t *ptr, uint16_t len, bool first) {
+  static const uint8_t *pos; // where TXD.PTR has got to
+  if (first) {
+    pos = ptr;
+    errata_198_saved = ERRATA_198_REG;
+    ERRATA_198_REG = 0;
+    BUS->DCXCNT = 0;
+    BUS->TXD.PTR = (uint32_t)ptr;
+    // ArrayList: TXD.PTR advances by MAXCNT after every transfer, so the
+    // follow-up chunks only need a new MAXCNT and a START.
+    BUS->TXD.LIST = SPIM_TXD_LIST_LIST_ArrayList << SPIM_TXD_LIST_LIST_Pos;
+    BUS->EVENTS_END = 0;
+    job = true;
+    BUS->INTENSET = SPIM_INTENSET_END_Msk;
+  }
+  ERRATA_198_REG |= ram_blocks(pos, len);
+  pos += len;
+  BUS->TXD.MAXCNT = len;
+  BUS->TASKS_START = 1;
+}
+
+static void bus_finish(void) {
+  ERRATA_198_REG = errata_198_saved;
+  BUS->INTENCLR = SPIM_INTENCLR_END_Msk;
+  BUS->TXD.LIST = SPIM_TXD_LIST_LIST_Disabled << SPIM_TXD_LIST_LIST_Pos;
+  job = false;
+}
+
+const disp_flush_backend_t disp_bus_backend = {bus_start, bus_finish};
+
+extern "C" void BUS_IRQHandler(void) {
+  if (BUS->EVENTS_END) {
+    BUS->EVENTS_END = 0;
+    (void)BUS->EVENTS_END; // flush the write before leaving the ISR
+    if (job)
+      disp_flush_chunk_done();
+  }
+}
@@ -0,0 +1,75 @@
+#include "disp_coalesce.h"
+#include "disp_vscroll.h"
+#include "latency_trace.h"
+#include "perf_trace.h"
+
+// Invalid area coalescing.
+// LVGL only joins two areas when the union is smaller than both together.
+// Here two areas are merged whenever sending the extra pixels of the
+// bounding box is cheaper than setting up one more address window, e.g. the
+// old/new positions of the clock hands that overlap around the centre.
+
+static uint32_t last_merges = 0;
+
+static inline uint32_t area_bytes(const lv_area_t *a) {
+  return lv_area_get_size(a) * sizeof(lv_color_t);
+}
+
+static uint32_t coalesce_areas(lv_disp_t *disp) {
+  uint32_t merges = 0;
+  bool merged;
+
+  do {
+    merged = false;
+    for (uint32_t i = 0; i < disp->inv_p; i++) {
+      if (disp->inv_area_joined[i])
+        continue;
+      for (uint32_t j = i + 1; j < disp->inv_p; j++) {
+        if (disp->inv_area_joined[j])
+          continue;
+
+        lv_area_t u;
+        _lv_area_join(&u, &disp->inv_areas[i], &disp->inv_areas[j]);
+        uint32_t separate = area_bytes(&disp->inv_areas[i]) +
+                            area_bytes(&disp->inv_areas[j]) +
+                            DISP_COALESCE_AREA_COST;
+        if (area_bytes(&u) > separate)
+          continue;
+
+        lv_area_copy(&disp->inv_areas[i], &u);
+        disp->inv_area_joined[j] = 1;
+        merges++;
+        merged = true;
+      }
+    }
+  } while (merged);
+
+  return merges;
+}
+
+static void coalesce_refr_timer(lv_timer_t *timer) {
+  lv_disp_t *disp = (lv_disp_t *)timer->user_data;
+  PERF_REFR_BEGIN();
+  LAT_TRACE_REFR_BEGIN();
+  DISP_VSCROLL_PREPARE(disp);
+  last_merges = coalesce_areas(disp);
+  DISP_VSCROLL_SPLIT(disp); // after merging: no window may wrap
+  _lv_disp_refr_timer(timer);
+  PERF_REFR_END();
+
+  // Nothing left to draw: stop waking up for the refresh period.
+  // _lv_inv_area() resumes the timer on the next invalidation.
+  if (disp->inv_p == 0)
+    lv_timer_pause(timer);
+}
+
+void disp_coalesce_init(lv_disp_t *disp) {
+  lv_timer_set_cb(disp->refr_timer, coalesce_refr_timer);
+}
+
+void disp_coalesce_refr_now(lv_disp_t *disp) {
+  lv_anim_refr_now();
+  coalesce_refr_timer(disp->refr_timer);
+}
+
+uint32_t disp_coalesce_last_merges(void) { return last_merges; }
@@ -0,0 +1,105 @@
+#include "disp_flush.h"
+#include "latency_trace.h"
+#include "perf_trace.h"
+#include <Arduino.h>
+
+// Asynchronous pixel flush.
+// The frame is pushed as a chain of EasyDMA chunks so the CPU returns to LVGL
+// right after the first chunk is started; lv_disp_flush_ready() comes from the
+// end-of-transfer interrupt of the last chunk.
+
+typedef struct {
+  lv_disp_drv_t *disp;
+  uint32_t remaining; // bytes not yet handed to the backend
+  bool last;          // last area of the refresh
+} disp_flush_job_t;
+
+static volatile disp_flush_job_t job;
+static volatile bool busy = false;
+static volatile bool reserved = false; // busy held for a deferred start
+static void (*reserved_start)(void) = NULL;
+static const disp_flush_backend_t *backend = NULL;
+
+static disp_flush_stats_t frame_acc;  // refresh in progress
+static disp_flush_stats_t frame_last; // last completed refresh
+
+static inline uint16_t next_chunk_len(uint32_t remaining) {
+  return (remaining > DISP_FLUSH_CHUNK_MAX) ? DISP_FLUSH_CHUNK_MAX
+                                            : (uint16_t)remaining;
+}
+
+void disp_flush_init(const disp_flush_backend_t *be) { backend = be; }
+
+void disp_flush_start(lv_disp_drv_t *disp, const uint8_t *data,
+                      uint32_t bytes) {
+  if (reserved)
+    reserved = false; // the bus was kept idle for this flush
+  else
+    disp_flush_wait();
+
+  bool last = lv_disp_flush_is_last(disp);
+  PERF_FLUSH_BEGIN(bytes, last);
+
+  frame_acc.areas++;
+  frame_acc.bytes += bytes;
+  if (last) {
+    frame_last = frame_acc;
+    frame_acc.areas = 0;
+    frame_acc.bytes = 0;
+  }
+
+  if (bytes == 0) {
+    busy = false;
+    PERF_FLUSH_END();
+    LAT_TRACE_FLUSH_DONE(last);
+    lv_disp_flush_ready(disp);
+    return;
+  }
+
+  uint16_t len = next_chunk_len(bytes);
+  job.disp = disp;
+  job.remaining = bytes - len;
+  job.last = last;
+  busy = true;
+  backend->start(data, len, true);
+}
+
+void disp_flush_chunk_done(void) {
+  if (job.remaining > 0) {
+    uint16_t len = next_chunk_len(job.remaining);
+    job.remaining -= len;
+    backend->start(NULL, len, false);
+    return;
+  }
+
+  backend->finish();
+  busy = false;
+  PERF_FLUSH_END();
+  LAT_TRACE_FLUSH_DONE(job.last);
+  lv_disp_flush_ready(job.disp);
+}
+
+void disp_flush_reserve(void (*start)(void)) {
+  disp_flush_wait();
+  reserved_start = start;
+  reserved = true;
+  busy = true;
+}
+
+bool disp_flush_busy(void) { return busy; }
+
+void disp_flush_get_frame_stats(disp_flush_stats_t *out) { *out = frame_last; }
+
+void disp_flush_wait(void) {
+  if (reserved && reserved_start != NULL) {
+    void (*start)(void) = reserved_start;
+    reserved_start = NULL;
+    start(); // calls disp_flush_start(), which ends the reservation
+  }
+  if (!busy)
+    return;
+  PERF_WAIT_BEGIN();
+  while (busy) {
+  }
+  PERF_WAIT_END();
+}
@@ -0,0 +1,176 @@
+#include "disp_te.h"
+
+#if DISP_TE_MODE != DISP_TE_OFF
+#include "disp_bus.h"
+#include "disp_flush.h"
+#include "FunctionalInterrupt.h"
+#include "idle_sched.h"
+#include <Arduino.h>
+
+// Presentation is counted in panel frames ("edges"). Each refresh is
+// presented on the first edge after it is ready; a gap of more edges than
+// the divisor between two presented frames of an animation is a jank.
+
+#define ST7789_TEON 0x35
+#define ST7789_FRCTRL2 0xC6
+
+#define TE_PERIOD_US (1000000 / DISP_PANEL_HZ)
+#define PACE_DECAY_FRAMES 30  // clean frames that forget an isolated jank
+#define PACE_PROBE_FRAMES 120 // clean frames before trying a shorter period
+
+static lv_timer_t *refr_timer = NULL;
+static uint8_t divisor = DISP_TE_MIN_DIV;
+static bool in_frame = false; // first area of this refresh already seen
+static uint32_t last_edge = 0;
+static uint32_t clean = 0;       // frames since the last jank
+static uint8_t recent_janks = 0; // janks not yet decayed
+static disp_te_stats_t stats;
+
+#if DISP_TE_MODE == DISP_TE_PIN
+static volatile uint32_t edges = 0;
+static disp_te_flush_t flush_cb = NULL;
+
+// First area of a refresh, waiting for the edge after `deferred_edge`.
+// Only the main loop touches it; the ISR just counts and, while an area
+// waits, wakes the loop up.
+static lv_disp_drv_t *volatile deferred_drv = NULL;
+static lv_area_t deferred_area;
+static lv_color_t *deferred_px;
+static uint32_t deferred_edge;
+
+static void te_isr(void *ctx) {
+  (void)ctx;
+  edges++;
+  if (deferred_drv != NULL)
+    idle_sched_wake_from_isr();
+}
+
+static void start_deferred(void) {
+  lv_disp_drv_t *drv = deferred_drv;
+  deferred_drv = NULL;
+  flush_cb(drv, &deferred_area, deferred_px);
+}
+
+// LVGL spins here while the deferred area holds the other buffer
+static void te_wait_cb(lv_disp_drv_t *drv) {
+  (void)drv;
+  disp_te_service();
+}
+
+static inline uint32_t te_edges(void) { return edges; }
+#else
+static uint32_t te_t0 = 0;
+static uint32_t te_base = 0;
+
+// Whole panel frames since init; rebased every minute so micros() wrapping
+// never shows up as a jump
+static uint32_t te_edges(void) {
+  uint32_t n = (micros() - te_t0) / TE_PERIOD_US;
+  if (n >= 60 * DISP_PANEL_HZ) {
+    te_t0 += 60 * DISP_PANEL_HZ * TE_PERIOD_US;
+    te_base += 60 * DISP_PANEL_HZ;
+    n -= 60 * DISP_PANEL_HZ;
+  }
+  return te_base + n;
+}
+#endif
+
+// Wake up just before the edge, so the refresh is rendered when it comes
+static void apply_period(void) {
+  lv_timer_set_period(refr_timer, divisor * 1000 / DISP_PANEL_HZ - 1);
+}
+
+static void pace(uint32_t gap) {
+  if (gap > divisor) {
+    stats.janks++;
+    stats.missed += gap - divisor;
+    clean = 0;
+    if (++recent_janks >= 2 && divisor < DISP_TE_MAX_DIV) {
+      divisor++;
+      recent_janks = 0;
+      apply_period();
+    }
+    return;
+  }
+
+  clean++;
+  if (clean == PACE_DECAY_FRAMES)
+    recent_janks = 0;
+  if (clean >= PACE_PROBE_FRAMES && divisor > DISP_TE_MIN_DIV) {
+    divisor--;
+    clean = 0;
+    apply_period();
+  }
+}
+
+void disp_te_init(lv_disp_t *disp, disp_te_flush_t flush) {
+  uint8_t rate = DISP_PANEL_FRCTRL2;
+  disp_bus_command(ST7789_FRCTRL2, &rate, 1);
+
+#if DISP_TE_MODE == DISP_TE_PIN
+  uint8_t vblank_only = 0x00;
+  disp_bus_command(ST7789_TEON, &vblank_only, 1);
+  flush_cb = flush;
+  disp->driver->wait_cb = te_wait_cb;
+  pinMode(TFT_TE, INPUT);
+  fi_attach(TFT_TE, te_isr, NULL, RISING);
+#else
+  (void)flush;
+  te_t0 = micros();
+#endif
+
+  refr_timer = disp->refr_timer;
+  apply_period();
+}
+
+bool disp_te_defer_flush(lv_disp_drv_t *drv, const lv_area_t *area,
+                         lv_color_t *color_p) {
+  bool first = !in_frame;
+  in_frame = !lv_disp_flush_is_last(drv);
+  if (!first)
+    return false;
+
+#if DISP_TE_MODE == DISP_TE_PIN
+  uint32_t e = te_edges() + 1; // the bus is idle: it goes out on the next edge
+#else
+  uint32_t e = te_edges();
+#endif
+  uint32_t gap = e - last_edge;
+  last_edge = e;
+
+  // Longer gaps are idle time between animations, not missed frames
+  if (gap <= 2 * DISP_TE_MAX_DIV) {
+    stats.frames++;
+    pace(gap);
+  }
+
+#if DISP_TE_MODE == DISP_TE_PIN
+  deferred_area = *area;
+  deferred_px = color_p;
+  deferred_edge = te_edges();
+  deferred_drv = drv;
+  // Anyone else needing the bus first sends the area right away
+  disp_flush_reserve(start_deferred);
+  return true;
+#else
+  (void)area;
+  (void)color_p;
+  return false;
+#endif
+}
+
+void disp_te_service(void) {
+#if DISP_TE_MODE == DISP_TE_PIN
+  if (deferred_drv != NULL && te_edges() != deferred_edge)
+    start_deferred();
+#endif
+}
+
+void disp_te_get_stats(disp_te_stats_t *out) {
+  *out = stats;
+  out->divisor = divisor;
+  stats.frames = 0;
+  stats.janks = 0;
+  stats.missed = 0;
+}
+#endif
@@ -0,0 +1,211 @@
+#include "disp_vscroll.h"
+
+#if DISP_VSCROLL
+#if defined(NRF52840_XXAA)
+#include "disp_bus.h"
+#endif
+
+// The scroll area is the visible 280 rows of the 320-row frame memory.
+// Screen row y is scanned from frame row (y + off) % rows, so moving the
+// content down by dy is off -= dy plus a redraw of the dy rows it exposes.
+//
+// LVGL invalidates the whole scroller after every scroll step. That
+// invalidation passes through rounder_cb right after LV_EVENT_SCROLL and is
+// turned into an empty marker there, so areas invalidated later in the same
+// frame are still recorded separately instead of being swallowed by it.
+
+#define ST7789_VSCRDEF 0x33
+#define ST7789_VSCSAD 0x37
+#define PANEL_ROWS 320 // ST7789 frame memory
+
+static lv_obj_t *scroller = NULL;
+static void (*next_rounder)(lv_disp_drv_t *drv, lv_area_t *area) = NULL;
+static lv_coord_t rows = 0;       // scroll area height (screen rows)
+static uint16_t off = 0;          // frame row of screen row 0
+static uint16_t shown = 0;        // offset the panel scans with
+static lv_coord_t last_x = 0;     // scroll position at the previous event
+static lv_coord_t applied_y = 0;  // scroll position the panel shows
+static bool armed = false; // next full-screen invalidation is the scroll's
+static bool moved = false; // a scroll invalidation was dropped this frame
+static uint32_t shifts = 0;
+
+static void send_offset(uint16_t o) {
+#if defined(NRF52840_XXAA)
+  uint16_t ssa = DISP_BUS_ROW_OFFSET + o;
+  uint8_t d[2] = {(uint8_t)(ssa >> 8), (uint8_t)ssa};
+  disp_bus_command(ST7789_VSCSAD, d, sizeof(d));
+#else
+  (void)o;
+#endif
+}
+
+static void scroll_cb(lv_event_t *e) {
+  (void)e;
+  lv_coord_t x = lv_obj_get_scroll_x(scroller);
+  // Anything drawn over the scroller would be shifted along with it
+  armed = x == last_x && lv_obj_get_screen(scroller) == lv_scr_act() &&
+          !lv_obj_has_flag(scroller, LV_OBJ_FLAG_HIDDEN) &&
+          lv_obj_get_child_cnt(lv_layer_top()) == 0 &&
+          lv_obj_get_child_cnt(lv_layer_sys()) == 0;
+  last_x = x;
+}
+
+static void rounder_cb(lv_disp_drv_t *drv, lv_area_t *area) {
+  if (next_rounder)
+    next_rounder(drv, area);
+  if (!armed)
+    return;
+
+  armed = false;
+  if (area->x1 == 0 && area->y1 == 0 && area->x2 == drv->hor_res - 1 &&
+      area->y2 == drv->ver_res - 1) {
+    *area = {0, 0, -1, -1}; // replaced in disp_vscroll_prepare()
+    moved = true;
+  }
+}
+
+void disp_vscroll_attach(lv_disp_t *disp, lv_obj_t *obj) {
+  scroller = obj;
+  rows = lv_disp_get_ver_res(disp);
+
+#if defined(NRF52840_XXAA)
+  uint16_t tfa = DISP_BUS_ROW_OFFSET;
+  uint16_t bfa = PANEL_ROWS - tfa - rows;
+  uint8_t d[6] = {(uint8_t)(tfa >> 8),  (uint8_t)tfa,
+                  (uint8_t)(rows >> 8), (uint8_t)rows,
+                  (uint8_t)(bfa >> 8),  (uint8_t)bfa};
+  disp_bus_command(ST7789_VSCRDEF, d, sizeof(d));
+#endif
+  send_offset(0);
+
+  last_x = lv_obj_get_scroll_x(obj);
+  applied_y = lv_obj_get_scroll_y(obj);
+  lv_obj_set_scrollbar_mode(obj, LV_SCROLLBAR_MODE_OFF);
+  lv_obj_add_event_cb(obj, scroll_cb, LV_EVENT_SCROLL, NULL);
+
+  next_rounder = disp->driver->rounder_cb;
+  disp->driver->rounder_cb = rounder_cb;
+}
+
+static void redraw_all(lv_disp_t *disp) {
+  disp->inv_areas[0] = {0, 0, (lv_coord_t)(lv_disp_get_hor_res(disp) - 1),
+                        (lv_coord_t)(rows - 1)};
+  disp->inv_area_joined[0] = 0;
+  disp->inv_p = 1;
+}
+
+static bool add_area(lv_disp_t *disp, const lv_area_t *a) {
+  for (uint16_t i = 0; i < disp->inv_p; i++) {
+    if (!disp->inv_area_joined[i] &&
+        _lv_area_is_in(a, &disp->inv_areas[i], 0))
+      return true;
+  }
+  if (disp->inv_p >= LV_INV_BUF_SIZE)
+    return false;
+  lv_area_copy(&disp->inv_areas[disp->inv_p], a);
+  disp->inv_area_joined[disp->inv_p] = 0;
+  disp->inv_p++;
+  return true;
+}
+
+void disp_vscroll_prepare(lv_disp_t *disp) {
+  armed = false;
+  lv_coord_t y = lv_obj_get_scroll_y(scroller);
+  lv_coord_t dy = applied_y - y; // content moved down by dy
+  applied_y = y;
+
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < disp->inv_p; i++) {
+    if (disp->inv_areas[i].x2 < disp->inv_areas[i].x1)
+      continue; // marker
+    disp->inv_areas[n] = disp->inv_areas[i];
+    disp->inv_area_joined[n] = disp->inv_area_joined[i];
+    n++;
+  }
+  disp->inv_p = n;
+
+  if (!moved)
+    return;
+  moved = false;
+  if (dy == 0)
+    return; // moved back to where it was
+  if (LV_ABS(dy) >= rows) {
+    redraw_all(disp);
+    return;
+  }
+
+  // Content that changed this frame may sit on either side of the shift
+  lv_coord_t w = lv_disp_get_hor_res(disp);
+  lv_area_t scr = {0, 0, (lv_coord_t)(w - 1), (lv_coord_t)(rows - 1)};
+  bool ok = true;
+  for (uint16_t i = 0, cnt = disp->inv_p; ok && i < cnt; i++) {
+    lv_area_t a = disp->inv_areas[i];
+    a.y1 += dy;
+    a.y2 += dy;
+    lv_area_t c;
+    if (_lv_area_intersect(&c, &a, &scr))
+      ok = add_area(disp, &c);
+  }
+
+  lv_area_t strip = scr; // exposed rows
+  if (dy > 0)
+    strip.y2 = dy - 1;
+  else
+    strip.y1 = rows + dy;
+  if (!ok || !add_area(disp, &strip))
+    redraw_all(disp);
+
+  off = (off - dy + rows) % rows;
+  shifts++;
+}
+
+void disp_vscroll_split(lv_disp_t *disp) {
+  if (off == 0)
+    return;
+
+  lv_coord_t wrap = rows - off; // first screen row stored in frame row 0
+  for (uint16_t i = 0, cnt = disp->inv_p; i < cnt; i++) {
+    lv_area_t *a = &disp->inv_areas[i];
+    if (disp->inv_area_joined[i] || a->y1 >= wrap || a->y2 < wrap)
+      continue;
+
+    if (disp->inv_p >= LV_INV_BUF_SIZE) { // no room: two full-width halves
+      redraw_all(disp);
+      lv_area_t rest = disp->inv_areas[0];
+      rest.y1 = wrap;
+      disp->inv_areas[0].y2 = wrap - 1;
+      add_area(disp, &rest);
+      return;
+    }
+    lv_area_t lower = *a;
+    lower.y1 = wrap;
+    a->y2 = wrap - 1;
+    add_area(disp, &lower);
+  }
+}
+
+void disp_vscroll_before_flush(void) {
+  if (shown != off) {
+    send_offset(off);
+    shown = off;
+  }
+}
+
+uint16_t disp_vscroll_row(lv_coord_t y) {
+  uint16_t r = y + off;
+  return r >= rows ? r - rows : r;
+}
+
+void disp_vscroll_reset(lv_disp_t *disp) {
+  armed = false;
+  moved = false;
+  if (scroller != NULL)
+    applied_y = lv_obj_get_scroll_y(scroller);
+  if (off == 0)
+    return;
+  off = 0;
+  lv_obj_invalidate(lv_disp_get_scr_act(disp)); // every row moves
+}
+
+uint32_t disp_vscroll_shifts(void) { return shifts; }
+#endif
@@ -0,0 +1,70 @@
+#include "FunctionalInterrupt.h"
+
+typedef struct {
+  bool used;
+  uint8_t pin;
+  fi_handler_t handler; // NULL while claimed but not attached
+  void *ctx;
+  alignas(8) uint8_t storage[FI_CALLABLE_BYTES];
+} fi_slot_t;
+
+static fi_slot_t slots[FI_SLOTS];
+
+template <int N> static void IRAM_ATTR slot_isr(void) {
+  fi_handler_t handler = slots[N].handler;
+  if (handler)
+    handler(slots[N].ctx);
+}
+
+static voidFuncPtr const isrs[FI_SLOTS] = {
+    slot_isr<0>, slot_isr<1>, slot_isr<2>, slot_isr<3>,
+    slot_isr<4>, slot_isr<5>, slot_isr<6>, slot_isr<7>,
+};
+
+static int slot_of(uint8_t pin) {
+  for (int i = 0; i < FI_SLOTS; i++)
+    if (slots[i].used && slots[i].pin == pin)
+      return i;
+  return -1;
+}
+
+static int take(uint8_t pin) {
+  fi_detach(pin);
+  for (int i = 0; i < FI_SLOTS; i++) {
+    if (!slots[i].used) {
+      slots[i].used = true;
+      slots[i].pin = pin;
+      slots[i].handler = NULL;
+      return i;
+    }
+  }
+  return -1;
+}
+
+void fi_detach(uint8_t pin) {
+  int i = slot_of(pin);
+  if (i < 0)
+    return;
+  if (slots[i].handler)
+    detachInterrupt(digitalPinToInterrupt(pin));
+  slots[i].handler = NULL;
+  slots[i].used = false;
+}
+
+void *fi_claim(uint8_t pin) {
+  int i = take(pin);
+  return i < 0 ? NULL : slots[i].storage;
+}
+
+bool fi_attach(uint8_t pin, fi_handler_t handler, void *ctx, uint32_t mode) {
+  int i = slot_of(pin);
+  if (i < 0 || slots[i].handler != NULL)
+    i = take(pin); // not claimed beforehand
+  if (i < 0)
+    return false;
+
+  slots[i].ctx = ctx;
+  slots[i].handler = handler;
+  attachInterrupt(digitalPinToInterrupt(pin), isrs[i], mode);
+  return true;
+}
@@ -0,0 +1,158 @@
+#include "gesture.h"
+#include "spsc_ring.h"
+#include <stdlib.h>
+
+// IDLE -> HOLD on a press. HOLD ends as a flick (-> FLICK, the rest of the
+// stroke is dropped), as a tap (release inside the window) or as a drag
+// (window over); the last two replay the held samples to LVGL. A stroke
+// whose release never arrives ends after TOUCH_RELEASE_TIMEOUT_MS of
+// silence, so a lost UP cannot swallow the next stroke.
+typedef enum { G_IDLE, G_HOLD, G_DRAG, G_FLICK } g_state_t;
+
+static g_state_t state = G_IDLE;
+static touch_sample_t hold[GESTURE_HOLD_DEPTH];
+static uint8_t held = 0;
+static touch_sample_t last; // latest sample fed
+static SpscRing<gesture_point_t, 32> out;
+static bool (*flick_cb)(lv_dir_t dir) = NULL;
+static uint32_t flicks = 0;
+
+static bool is_pressed(const touch_sample_t *s) {
+  return s->fingers != 0 && s->event != TOUCH_EVENT_UP;
+}
+
+static void emit(const touch_sample_t *s) {
+  gesture_point_t p = {{(lv_coord_t)s->x, (lv_coord_t)s->y}, is_pressed(s),
+                       s->t_ms};
+  out.push(p);
+}
+
+static void replay(void) {
+  for (uint8_t i = 0; i < held; i++)
+    emit(&hold[i]);
+  held = 0;
+}
+
+static lv_dir_t slide_dir(uint8_t gesture) {
+  switch (gesture) {
+  case CST816S_GESTURE_SLIDE_UP:
+    return LV_DIR_TOP;
+  case CST816S_GESTURE_SLIDE_DOWN:
+    return LV_DIR_BOTTOM;
+  case CST816S_GESTURE_SLIDE_LEFT:
+    return LV_DIR_LEFT;
+  case CST816S_GESTURE_SLIDE_RIGHT:
+    return LV_DIR_RIGHT;
+  default:
+    return LV_DIR_NONE;
+  }
+}
+
+// Finger direction if the held stroke is a flick. The velocity from the
+// samples decides; the controller's slide code only counts on release,
+// for strokes too short to have been sampled well.
+static lv_dir_t classify(bool released) {
+  const touch_sample_t *a = &hold[0];
+  const touch_sample_t *b = &hold[held - 1];
+  int32_t dx = (int32_t)b->x - a->x;
+  int32_t dy = (int32_t)b->y - a->y;
+  int32_t dt = (int32_t)(b->t_ms - a->t_ms);
+  int32_t major = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+  int32_t minor = abs(dx) > abs(dy) ? abs(dy) : abs(dx);
+
+  if (dt > 0 && major >= GESTURE_FLICK_MIN_PX && major > 2 * minor &&
+      major * 1000 >= GESTURE_FLICK_PX_PER_S * dt) {
+    if (abs(dx) > abs(dy))
+      return dx < 0 ? LV_DIR_LEFT : LV_DIR_RIGHT;
+    return dy < 0 ? LV_DIR_TOP : LV_DIR_BOTTOM;
+  }
+  if (released)
+    return slide_dir(b->gesture);
+  return LV_DIR_NONE;
+}
+
+static bool fire(lv_dir_t dir) {
+  if (dir == LV_DIR_NONE || flick_cb == NULL || !flick_cb(dir))
+    return false;
+  flicks++;
+  held = 0;
+  return true;
+}
+
+// The stroke's release was lost: end it, letting LVGL release what it had
+static void expire(uint32_t now_ms) {
+  if (state == G_IDLE || now_ms - last.t_ms <= TOUCH_RELEASE_TIMEOUT_MS)
+    return;
+  if (state == G_HOLD)
+    replay();
+  if (state != G_FLICK) {
+    touch_sample_t up = last;
+    up.fingers = 0;
+    up.event = TOUCH_EVENT_UP;
+    emit(&up);
+  }
+  held = 0;
+  state = G_IDLE;
+}
+
+void gesture_init(bool (*on_flick)(lv_dir_t dir)) { flick_cb = on_flick; }
+
+void gesture_feed(const touch_sample_t *s) {
+  bool down = is_pressed(s);
+
+  // The read timer sleeps through a flick, so a lost UP shows up here
+  expire(s->t_ms);
+  last = *s;
+
+  switch (state) {
+  case G_IDLE:
+    if (!down || GESTURE_FLICK_MS == 0) {
+      emit(s);
+      state = down ? G_DRAG : G_IDLE;
+      return;
+    }
+    hold[0] = *s;
+    held = 1;
+    state = G_HOLD;
+    return;
+
+  case G_HOLD:
+    hold[held++] = *s;
+    if (fire(classify(!down))) {
+      state = down ? G_FLICK : G_IDLE;
+    } else if (!down) {
+      replay(); // tap, or too short to tell
+      state = G_IDLE;
+    } else if (held == GESTURE_HOLD_DEPTH ||
+               s->t_ms - hold[0].t_ms >= GESTURE_FLICK_MS) {
+      replay();
+      state = G_DRAG;
+    }
+    return;
+
+  case G_DRAG:
+    emit(s);
+    if (!down)
+      state = G_IDLE;
+    return;
+
+  case G_FLICK:
+    if (!down)
+      state = G_IDLE;
+    return;
+  }
+}
+
+void gesture_poll(uint32_t now_ms) {
+  if (state == G_HOLD && now_ms - hold[0].t_ms >= GESTURE_FLICK_MS) {
+    replay();
+    state = G_DRAG;
+  }
+  expire(now_ms);
+}
+
+bool gesture_pop(gesture_point_t *p) { return out.pop(*p); }
+
+bool gesture_pending(void) { return state == G_HOLD || !out.empty(); }
+
+uint32_t gesture_flicks(void) { return flicks; }
@@ -0,0 +1,65 @@
+#include "idle_sched.h"
+#include <Arduino.h>
+
+// Tickless main loop support.
+// The loop task blocks on its task notification; FreeRTOS tickless idle
+// sleeps until the timeout or until an ISR posts a notification. A
+// notification posted before the loop goes to sleep is not lost: the next
+// idle_sched_sleep() returns immediately.
+
+static TaskHandle_t loop_task = NULL;
+
+static uint32_t window_start_us = 0;
+static uint32_t awake_since_us = 0;
+static uint32_t awake_us = 0;
+static uint32_t wakeups = 0;
+
+void idle_sched_init(void) {
+  loop_task = xTaskGetCurrentTaskHandle();
+  window_start_us = micros();
+  awake_since_us = window_start_us;
+}
+
+void idle_sched_sleep(uint32_t max_ms) {
+  if (max_ms == 0)
+    return;
+
+  awake_us += micros() - awake_since_us;
+
+  TickType_t ticks =
+      (max_ms == IDLE_SLEEP_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(max_ms);
+  if (ticks == 0)
+    ticks = 1;
+  ulTaskNotifyTake(pdTRUE, ticks);
+
+  awake_since_us = micros();
+  wakeups++;
+}
+
+void idle_sched_wake_from_isr(void) {
+  if (loop_task == NULL)
+    return;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(loop_task, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+void idle_sched_get_stats(idle_sched_stats_t *out) {
+  uint32_t now = micros();
+  uint32_t elapsed = now - window_start_us;
+  uint32_t awake = awake_us + (now - awake_since_us);
+  if (elapsed == 0)
+    elapsed = 1;
+
+  out->wakeups_per_s_x10 = (uint32_t)((uint64_t)wakeups * 10000000 / elapsed);
+  out->duty_permille = (uint32_t)((uint64_t)awake * 1000 / elapsed);
+  out->est_current_ua =
+      (IDLE_RUN_CURRENT_UA * out->duty_permille +
+       IDLE_SLEEP_CURRENT_UA * (1000 - out->duty_permille)) /
+      1000;
+
+  window_start_us = now;
+  awake_since_us = now;
+  awake_us = 0;
+  wakeups = 0;
+}
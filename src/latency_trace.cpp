@@ -0,0 +1,114 @@
+#include "latency_trace.h"
+
+#ifdef LATENCY_TRACE
+#include "histo.h"
+#include <Arduino.h>
+
+// Stage timestamps of the touch being followed. `reached` is the last stage
+// seen (-1: idle); each hook only advances the chain from the stage before
+// it, so unrelated events, invalidations and flushes are ignored.
+
+static uint32_t t[LAT_STAGES];
+static volatile int8_t reached = -1;
+static volatile bool rendering = false; // a refresh began after LAT_INV
+
+// Completed chains: [0] end-to-end, [s] stage s-1 -> s
+static uint32_t ring[LATENCY_TRACE_DEPTH][LAT_STAGES];
+static uint32_t ring_head = 0;
+static uint32_t ring_count = 0;
+
+static inline uint32_t now_us(void) {
+#if defined(NRF52840_XXAA)
+  return micros();
+#else
+  return millis() * 1000; // simulated time, so replays are reproducible
+#endif
+}
+
+static inline void advance(lat_stage_t from, lat_stage_t to) {
+  if (reached != from)
+    return;
+  t[to] = now_us();
+  reached = to;
+}
+
+static void feedback_cb(lv_indev_drv_t *drv, uint8_t code) {
+  (void)drv;
+  (void)code;
+  advance(LAT_READ, LAT_EVENT);
+}
+
+static void rounder_cb(lv_disp_drv_t *drv, lv_area_t *area) {
+  (void)drv;
+  (void)area; // areas stay as they are
+  // The refresh also rounds its row bands (get_max_row); only invalidations
+  // count
+  if (_lv_refr_get_disp_refreshing() != NULL)
+    return;
+  advance(LAT_EVENT, LAT_INV);
+}
+
+void latency_trace_attach(lv_disp_drv_t *disp, lv_indev_drv_t *indev) {
+  disp->rounder_cb = rounder_cb;
+  indev->feedback_cb = feedback_cb;
+}
+
+void latency_trace_irq(void) {
+  uint32_t now = now_us();
+  if (reached >= 0 && now - t[LAT_IRQ] < LATENCY_TRACE_STALE_US)
+    return; // still following an earlier touch
+  t[LAT_IRQ] = now;
+  rendering = false;
+  reached = LAT_IRQ;
+}
+
+void latency_trace_read(void) { advance(LAT_IRQ, LAT_READ); }
+
+void latency_trace_refr_begin(void) {
+  if (reached == LAT_INV)
+    rendering = true;
+}
+
+void latency_trace_flush_done(bool last) {
+  if (!last || !rendering)
+    return;
+  t[LAT_PHOTON] = now_us();
+
+  uint32_t *rec = ring[ring_head];
+  rec[0] = t[LAT_PHOTON] - t[LAT_IRQ];
+  for (int s = 1; s < LAT_STAGES; s++)
+    rec[s] = t[s] - t[s - 1];
+  ring_head = (ring_head + 1) % LATENCY_TRACE_DEPTH;
+  if (ring_count < LATENCY_TRACE_DEPTH)
+    ring_count++;
+
+  rendering = false;
+  reached = -1;
+}
+
+void latency_trace_dump(void) {
+  static const char *const names[LAT_STAGES] = {
+      "total", "irq>read", "read>event", "event>inv", "inv>photon"};
+  static uint32_t v[LATENCY_TRACE_DEPTH];
+
+  if (ring_count == 0) {
+    Serial.printf("[lat] no touches traced\n");
+    return;
+  }
+
+  Serial.printf("[lat] last %lu touches\n", (unsigned long)ring_count);
+  for (int s = 0; s < LAT_STAGES; s++) {
+    noInterrupts();
+    uint32_t n = ring_count;
+    for (uint32_t i = 0; i < n; i++)
+      v[i] = ring[i][s];
+    interrupts();
+
+    histo_sort(v, n);
+    Serial.printf("[lat] %-10s p50=%lu p95=%lu p99=%lu max=%lu us\n",
+                  names[s], (unsigned long)histo_pct(v, n, 50),
+                  (unsigned long)histo_pct(v, n, 95),
+                  (unsigned long)histo_pct(v, n, 99), (unsigned long)v[n - 1]);
+  }
+}
+#endif
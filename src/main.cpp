@@ -2,11 +2,28 @@
 #include <CST816S.h>
 #include <FunctionalInterrupt.h>
 #include <TFT_eSPI.h>
+#include <SPI.h>
 #include <Wire.h>
-#include <functional>
+#include <backlight.h>
+#include <disp_bus.h>
+#include <disp_coalesce.h>
+#include <disp_flush.h>
+#include <disp_te.h>
+#include <disp_vscroll.h>
+#include <gesture.h>
+#include <idle_sched.h>
+#include <latency_trace.h>
 #include <lvgl.h>
+#include <perf_trace.h>
+#include <tile_cache.h>
+#include <timekeeping.h>
+#include <touch_bus.h>
+#include <touch_indev.h>
+#include <touch_input.h>
 #include <ui.h>
 
+#include "my_ui.h" // Add custom UI header
+
 // XIAOの標準I2Cピンとタッチパネル用ピン
 #define TOUCH_SDA D4
 #define TOUCH_SCL D5
@@ -29,70 +46,157 @@ CST816S touch(TOUCH_SDA, TOUCH_SCL, TOUCH_RST, TOUCH_INT);
 static const uint16_t screenWidth = 240;
 static const uint16_t screenHeight = 280;
 
+/* Draw buffer layout, selected with -D DISP_BUF_MODE in platformio.ini.
+ * With two buffers LVGL renders into one while the other is on the wire. */
+#define DISP_BUF_FULL 0    // one full frame (134 KB), no render/flush overlap
+#define DISP_BUF_QUARTER 1 // two 1/4-screen stripes (2 x 33.6 KB)
+#define DISP_BUF_TENTH 2   // two 1/10-screen stripes (2 x 13.4 KB)
+
+#ifndef DISP_BUF_MODE
+#define DISP_BUF_MODE DISP_BUF_TENTH
+#endif
+
+#if DISP_BUF_MODE == DISP_BUF_FULL
+static const uint32_t bufPixels = screenWidth * screenHeight;
+#elif DISP_BUF_MODE == DISP_BUF_QUARTER
+static const uint32_t bufPixels = screenWidth * screenHeight / 4;
+#elif DISP_BUF_MODE == DISP_BUF_TENTH
+static const uint32_t bufPixels = screenWidth * screenHeight / 10;
+#else
+#error "Unknown DISP_BUF_MODE"
+#endif
+
 static lv_disp_draw_buf_t draw_buf;
-static lv_color_t buf1[screenWidth * screenHeight];
-// static lv_color_t buf2[screenWidth * screenHeight / 2];
+static lv_color_t buf1[bufPixels];
+#if DISP_BUF_MODE != DISP_BUF_FULL
+static lv_color_t buf2[bufPixels];
+#endif
 
 TFT_eSPI tft = TFT_eSPI(screenWidth, screenHeight); /* TFT instance */
 
-// Backlight State
-static bool is_display_on = true;
+static lv_indev_t *indev = NULL; /* touch input device */
+
+// Display State
+// ON: full UI. AOD: dim always-on clock in panel partial + idle (8-colour)
+// mode, updated once per minute. OFF: panel asleep, backlight off.
+typedef enum { DISPLAY_OFF, DISPLAY_AOD, DISPLAY_ON } display_state_t;
+
+// -D DISP_AOD=0: the inactivity timeout turns the panel off instead
+#ifndef DISP_AOD
+#define DISP_AOD 1
+#endif
+#define DISPLAY_IDLE_STATE (DISP_AOD ? DISPLAY_AOD : DISPLAY_OFF)
+#define AOD_BRIGHTNESS 12 // backlight level in AOD (0-255)
+
+static display_state_t display_state = DISPLAY_ON;
+static bool aod_active = false; // panel and UI in AOD form
 static uint32_t last_touch_time = 0;
 static uint32_t display_wake_time = 0; // Tracks when display turned ON
 static int target_brightness = 255;    // Default max brightness
-static int current_brightness = 255;
-
-// Helper to set PWM directly
-void set_raw_brightness(int val) {
-  if (BL_ON == LOW)
-    val = 255 - val; // Invert control if needed
-  analogWrite(BACKLIGHT_PIN, val);
-
-  // Store localized brightness (regardless of hardware inversion)
-  if (BL_ON == LOW)
-    current_brightness = 255 - val;
-  else
-    current_brightness = val;
-}
+static uint32_t sleep_in_time = 0;     // last Sleep In sent to the panel
 
-// Helper to fade backlight
-void fade_backlight(bool in) {
-  int start = current_brightness;
-  int end = in ? target_brightness : 0;
-  int step = (start < end) ? 10 : -10; // Faster fade (snappy)
-
-  // Simple blocking fade
-  while (abs(current_brightness - end) > 10) {
-    current_brightness += step;
-    set_raw_brightness(current_brightness);
-    delay(5);
-  }
-  set_raw_brightness(end);
-}
+#define BL_FADE_MS 120 // Fade duration (snappy)
+#define SLEEP_OUT_AFTER_MS 120 // ST7789: Sleep In to the next Sleep Out
 
 // Function called from UI to update brightness setting
 void update_user_brightness(int val) {
   target_brightness = val;
-  if (is_display_on) {
-    set_raw_brightness(target_brightness);
+  if (display_state == DISPLAY_ON) {
+    backlight_set(target_brightness);
   }
 }
 
-void set_display_state(bool on) {
-  if (is_display_on == on)
+static int state_brightness(display_state_t state) {
+  return state == DISPLAY_ON ? target_brightness : AOD_BRIGHTNESS;
+}
+
+// Reduced clock face, then partial mode over its rows and idle mode.
+// Only the face is redrawn afterwards, so every flush lands in the window.
+static void set_aod(bool on) {
+  if (aod_active == on)
     return;
-  is_display_on = on;
+  aod_active = on;
 
+  lv_area_t live;
+  my_ui_set_aod(on, &live);
   if (on) {
-    display_wake_time = millis(); // Record wake time
-    tft.writecommand(0x11);       // Sleep Out
-    tft.writecommand(0x29);       // Display ON
-    delay(10);                    // Wait for TFT to wake
-    fade_backlight(true);         // Fade IN
+    // The partial area below is in frame rows: undo any panel scrolling
+    DISP_VSCROLL_RESET(lv_disp_get_default());
+    // full-colour frame of the reduced face first
+    disp_coalesce_refr_now(lv_disp_get_default());
+    disp_flush_wait();
+    uint16_t top = live.y1 + DISP_BUS_ROW_OFFSET;
+    uint16_t bottom = live.y2 + DISP_BUS_ROW_OFFSET;
+    uint8_t rows[4] = {(uint8_t)(top >> 8), (uint8_t)top,
+                       (uint8_t)(bottom >> 8), (uint8_t)bottom};
+    disp_bus_command(0x30, rows, sizeof(rows)); // Partial Area
+    disp_bus_command(0x12, NULL, 0);            // Partial Mode ON
+    disp_bus_command(0x39, NULL, 0);            // Idle Mode ON
   } else {
-    fade_backlight(false);  // Fade OUT
-    tft.writecommand(0x28); // Display OFF
-    tft.writecommand(0x10); // Sleep In
+    disp_flush_wait();
+    disp_bus_command(0x38, NULL, 0); // Idle Mode OFF
+    disp_bus_command(0x13, NULL, 0); // Normal Display Mode ON
+  }
+}
+
+// ST7789 needs 5 ms after Sleep Out before the next command
+static void display_on_timer_cb(lv_timer_t *timer) {
+  if (display_state == DISPLAY_OFF)
+    return;
+  set_aod(display_state == DISPLAY_AOD);
+  disp_flush_wait();
+  disp_bus_command(0x29, NULL, 0); // Display ON
+  backlight_fade_to(state_brightness(display_state), BL_FADE_MS,
+                    NULL); // Fade IN
+}
+
+// Runs once the fade-out ramp has finished (not if it was retargeted)
+static void display_off_fade_done(void) {
+  if (display_state != DISPLAY_OFF)
+    return;
+  disp_flush_wait();
+  disp_bus_command(0x28, NULL, 0); // Display OFF
+  disp_bus_command(0x10, NULL, 0); // Sleep In
+  sleep_in_time = millis();
+  disp_bus_enable(false);
+}
+
+// Deferred until SLEEP_OUT_AFTER_MS after the last Sleep In
+static void display_sleep_out_timer_cb(lv_timer_t *timer) {
+  if (display_state == DISPLAY_OFF)
+    return;
+  disp_flush_wait();
+  disp_bus_command(0x11, NULL, 0); // Sleep Out
+  lv_timer_t *t = lv_timer_create(display_on_timer_cb, 5, NULL);
+  lv_timer_set_repeat_count(t, 1);
+}
+
+// Non-blocking: the backlight fades run on the PWM peripheral and the panel
+// commands that must wait are deferred, so touch keeps flowing meanwhile.
+void set_display_state(display_state_t state) {
+  if (display_state == state)
+    return;
+  display_state_t prev = display_state;
+  display_state = state;
+
+  disp_flush_wait(); // Panel commands must not interleave with pixel DMA
+
+  if (state == DISPLAY_ON)
+    display_wake_time = millis(); // Record wake time
+
+  if (state == DISPLAY_OFF) {
+    set_aod(false); // wake up in normal mode later
+    backlight_fade_to(0, BL_FADE_MS, display_off_fade_done); // Fade OUT
+  } else if (prev == DISPLAY_OFF) {
+    disp_bus_enable(true);
+    uint32_t asleep = millis() - sleep_in_time;
+    uint32_t wait =
+        asleep < SLEEP_OUT_AFTER_MS ? SLEEP_OUT_AFTER_MS - asleep : 0;
+    lv_timer_t *t = lv_timer_create(display_sleep_out_timer_cb, wait, NULL);
+    lv_timer_set_repeat_count(t, 1);
+  } else { // ON <-> AOD, panel awake
+    set_aod(state == DISPLAY_AOD);
+    backlight_fade_to(state_brightness(state), BL_FADE_MS, NULL);
   }
 }
 
@@ -105,53 +209,187 @@ void my_print(const char *buf) {
 #endif
 
 /* Display flushing */
-#include <SPI.h> // Ensure SPI is available
-
-/* Display flushing */
-void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area,
-                   lv_color_t *color_p) {
+// Address window goes out synchronously (a few bytes); the pixel payload is
+// chained EasyDMA and completes in the background (see disp_flush.cpp).
+// Also runs from disp_te_service() for areas deferred to the vertical blank.
+static void flush_area(lv_disp_drv_t *disp, const lv_area_t *area,
+                       lv_color_t *color_p) {
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
 
-  tft.startWrite();
-  tft.setAddrWindow(area->x1, area->y1, w, h);
+  DISP_VSCROLL_BEFORE_FLUSH();
+  disp_bus_window(area->x1, DISP_VSCROLL_ROW(area->y1), area->x2,
+                  DISP_VSCROLL_ROW(area->y2));
+
+  disp_flush_start(disp, (const uint8_t *)&color_p->full, w * h * 2);
+}
 
-  // Direct SPI DMA Transfer (Chunked for nRF52 limit < 65535)
-  uint32_t total_bytes = w * h * 2;
-  uint8_t *data_ptr = (uint8_t *)&color_p->full;
-  const uint32_t chunk_size = 60000; // Safe chunk size under 64KB
+void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area,
+                   lv_color_t *color_p) {
+  disp_flush_wait();
+  if (DISP_TE_DEFER_FLUSH(disp, area, color_p))
+    return; // first area of a refresh: flushed at the next vblank
+  flush_area(disp, area, color_p);
+}
 
-  while (total_bytes > 0) {
-    uint32_t transfer_size =
-        (total_bytes > chunk_size) ? chunk_size : total_bytes;
-    SPI.transfer(data_ptr, transfer_size);
-    data_ptr += transfer_size;
-    total_bytes -= transfer_size;
+#ifdef DISP_BUS_BENCH
+/* Bus benchmark: full-frame fill from the draw buffer at each SPIM3 clock.
+ * 240x280x2 = 134400 bytes, i.e. 33.6 ms of pure wire time at 32 MHz. */
+static void disp_bus_bench(void) {
+  static const uint32_t freqs[] = {8000000, 16000000, 32000000};
+  static const uint16_t colors[] = {0xF800, 0x07E0, 0x001F};
+  const uint32_t frame = screenWidth * screenHeight * 2;
+
+  for (int i = 0; i < 3; i++) {
+    for (uint32_t p = 0; p < bufPixels; p++) // big-endian RGB565
+      buf1[p].full = (colors[i] >> 8) | (colors[i] << 8);
+
+    disp_bus_set_freq(freqs[i]);
+    uint32_t t0 = micros();
+    disp_bus_window(0, 0, screenWidth - 1, screenHeight - 1);
+    for (uint32_t sent = 0; sent < frame; sent += sizeof(buf1)) {
+      uint32_t n = frame - sent;
+      if (n > sizeof(buf1))
+        n = sizeof(buf1);
+      disp_bus_write((const uint8_t *)buf1, n);
+    }
+    uint32_t us = micros() - t0;
+    Serial.printf("[bus] %luMHz full frame %lu.%02lums (%lu kB/s)\n",
+                  freqs[i] / 1000000, us / 1000, (us % 1000) / 10,
+                  frame * 1000 / us);
+    delay(300);
   }
+  disp_bus_set_freq(DISP_BUS_HZ);
+}
+#endif
 
-  tft.endWrite();
+#if DISP_TE_MODE != DISP_TE_OFF
+static void print_te_stats(void) {
+  disp_te_stats_t st;
+  disp_te_get_stats(&st);
+  Serial.printf("[te] frames=%lu janks=%lu missed=%lu period=%u/%uHz\n",
+                st.frames, st.janks, st.missed, st.divisor, DISP_PANEL_HZ);
+}
+#endif
 
-  lv_disp_flush_ready(disp);
+#ifdef DISP_BENCH
+/* Buffer mode benchmark: prints refresh rate and draw buffer RAM every 5 s */
+void disp_bench_monitor(lv_disp_drv_t *disp, uint32_t time, uint32_t px) {
+  static uint32_t window_start = 0;
+  static uint32_t frames = 0;
+  static uint32_t busy_ms = 0;
+  static uint32_t pixels = 0;
+  static uint32_t areas = 0;
+  static uint32_t bytes = 0;
+
+  disp_flush_stats_t fs;
+  disp_flush_get_frame_stats(&fs);
+
+  frames++;
+  busy_ms += time;
+  pixels += px;
+  areas += fs.areas;
+  bytes += fs.bytes;
+
+  uint32_t now = millis();
+  if (now - window_start < 5000)
+    return;
+
+  uint32_t used = sizeof(buf1);
+#if DISP_BUF_MODE != DISP_BUF_FULL
+  used += sizeof(buf2);
+#endif
+  uint32_t full = screenWidth * screenHeight * sizeof(lv_color_t);
+  uint32_t elapsed = now - window_start;
+
+  Serial.printf("[bench] mode=%d fps=%lu.%lu refr=%lums px/frame=%lu "
+                "areas/frame=%lu.%lu bytes/frame=%lu buf=%luB freed=%ldB\n",
+                DISP_BUF_MODE, frames * 1000 / elapsed,
+                (frames * 10000 / elapsed) % 10, busy_ms / frames,
+                pixels / frames, areas / frames, (areas * 10 / frames) % 10,
+                bytes / frames, used, (long)full - (long)used);
+
+#if DISP_TE_MODE != DISP_TE_OFF
+  print_te_stats();
+#endif
+
+  uint32_t ticks;
+  uint32_t hand_us = my_ui_clock_render_us(&ticks);
+  if (ticks > 0)
+    Serial.printf("[bench] hands=%luus/tick (%s)\n", hand_us / ticks,
+                  CLOCK_SPRITES ? "sprites" : "lv_line");
+
+  window_start = now;
+  frames = 0;
+  busy_ms = 0;
+  pixels = 0;
+  areas = 0;
+  bytes = 0;
+}
+#endif
+
+static void print_touch_stats(void) {
+  touch_bus_stats_t st;
+  touch_input_get_bus_stats(&st);
+  uint32_t n = st.samples ? st.samples : 1;
+  const char *bus = st.dma ? "twim-dma 400kHz" : "wire 100kHz";
+  Serial.printf("[touch] %s samples=%lu errors=%lu cpu avg=%luus max=%luus "
+                "ready avg=%luus max=%luus flicks=%lu\n",
+                bus, st.samples, st.errors, st.cpu_us_sum / n, st.cpu_us_max,
+                st.ready_us_sum / n, st.ready_us_max, gesture_flicks());
 }
 
-/*Read the touchpad*/
-void my_touchpad_read(lv_indev_drv_t *indev_driver, lv_indev_data_t *data) {
-  // Serial.println("Reading touchpad..."); // デバッグ用 (Performance Impact)
-  if (touch.available()) {
-    data->state = LV_INDEV_STATE_PR; // 押されている状態
-    data->point.x = touch.data.x;
-    data->point.y = touch.data.y;
-
-    // Activity detected
-    last_touch_time = millis();
-    if (!is_display_on) {
-      set_display_state(true); // Wake up immediately
+/* Serial commands, one per line (see timekeeping.h)
+ *   P  dump the perf_trace histograms (-D PERF_TRACE) and the TE jank
+ *      counters (-D DISP_TE_MODE)
+ *   L  dump the touch-to-photon latencies (-D LATENCY_TRACE)
+ *   B  touch bus read costs and flick count */
+
+static void serial_service(void) {
+  static char line[24];
+  static uint8_t len = 0;
+
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (len < sizeof(line) - 1)
+        line[len++] = c;
+      continue;
+    }
+    if (len == 0)
+      continue;
+    line[len] = '\0';
+    len = 0;
+
+    if (timekeeping_command(line))
+      continue;
+    if (line[0] == 'B') {
+      print_touch_stats();
+      continue;
+    }
+    if (line[0] == 'P') {
+#ifdef PERF_TRACE
+      perf_trace_dump();
+#endif
+#if DISP_TE_MODE != DISP_TE_OFF
+      print_te_stats();
+#endif
+      continue;
+    }
+#ifdef LATENCY_TRACE
+    if (line[0] == 'L') {
+      latency_trace_dump();
+      continue;
     }
+#endif
+  }
+}
 
-    // デバッグ用
-    // Serial.printf("Touch: x=%d, y=%d\n", touch.data.x, touch.data.y);
-  } else {
-    data->state = LV_INDEV_STATE_REL; // 離されている状態
+// Touch activity keeps the display awake
+static void touch_pressed(void) {
+  last_touch_time = millis();
+  if (display_state != DISPLAY_ON) {
+    set_display_state(DISPLAY_ON); // Wake up immediately
   }
 }
 
@@ -163,8 +401,9 @@ void setup() {
   pinMode(D5, INPUT_PULLUP);
 
   // Backlight Init (PWM)
-  pinMode(BACKLIGHT_PIN, OUTPUT);
-  set_raw_brightness(target_brightness); // Start ON
+  if (!backlight_init(BACKLIGHT_PIN, BL_ON == HIGH))
+    Serial.println("[bl] PWM3 in use, backlight on/off only");
+  backlight_set(target_brightness); // Start ON
   last_touch_time = millis();
   display_wake_time = millis(); // Initial wake time
 
@@ -172,6 +411,12 @@ void setup() {
   Wire.begin();
   Wire.setClock(100000); // 100kHz（標準速度）で開始
   touch.begin();         // その後にタッチを初期化
+#ifdef TOUCH_BUS_DMA
+  Wire.end(); // reads move to the INT-triggered TWIM burst
+  touch_bus_init(TOUCH_SDA, TOUCH_SCL);
+#endif
+  touch_input_init(TOUCH_INT); // INT edge -> sample ring
+  touch_indev_init(touch_pressed);
   String LVGL_Arduino = "Hello Arduino! ";
   LVGL_Arduino += String('V') + lv_version_major() + "." + lv_version_minor() +
                   "." + lv_version_patch();
@@ -180,18 +425,30 @@ void setup() {
   Serial.println("I am LVGL_Arduino");
 
   lv_init();
+  PERF_TRACE_INIT();
 
 #if LV_USE_LOG != 0
   lv_log_register_print_cb(
       my_print); /* register print function for debugging */
 #endif
 
+  // TFT_eSPI only runs the panel init sequence: no pixel goes through it,
+  // so its byte swap setting plays no part (disp_flush.h has the check)
   tft.begin();             /* TFT init */
-  tft.setSwapBytes(false); // これでLVGLの代わりに色を正しく整えます
   // tft.invertDisplay(false); // 円形ディスプレイは色が反転しやすいため必須
   tft.setRotation(0); /* Landscape orientation, flipped */
+  SPI.end();          // panel is set up; SPIM3 now belongs to disp_bus
+  disp_bus_init(DISP_BUS_HZ);
+  disp_flush_init(&disp_bus_backend);
+#ifdef DISP_BUS_BENCH
+  disp_bus_bench();
+#endif
 
-  lv_disp_draw_buf_init(&draw_buf, buf1, NULL, screenWidth * screenHeight);
+#if DISP_BUF_MODE == DISP_BUF_FULL
+  lv_disp_draw_buf_init(&draw_buf, buf1, NULL, bufPixels);
+#else
+  lv_disp_draw_buf_init(&draw_buf, buf1, buf2, bufPixels);
+#endif
 
   /*Initialize the display*/
   static lv_disp_drv_t disp_drv;
@@ -201,22 +458,42 @@ void setup() {
   disp_drv.ver_res = screenHeight;
   disp_drv.flush_cb = my_disp_flush;
   disp_drv.draw_buf = &draw_buf;
-  lv_disp_drv_register(&disp_drv);
+#ifdef DISP_BENCH
+  disp_drv.monitor_cb = disp_bench_monitor;
+#endif
+  lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+  disp_coalesce_init(disp);
+#if DISP_TE_MODE != DISP_TE_OFF
+  disp_te_init(disp, flush_area);
+#endif
 
   /*Initialize the (dummy) input device driver*/
   static lv_indev_drv_t indev_drv;
   lv_indev_drv_init(&indev_drv);
   indev_drv.type = LV_INDEV_TYPE_POINTER;
-  indev_drv.read_cb = my_touchpad_read;
-  lv_indev_drv_register(&indev_drv);
-
-#include "my_ui.h" // Add custom UI header
+  indev_drv.read_cb = touch_indev_read;
+  indev = lv_indev_drv_register(&indev_drv);
+#ifdef LATENCY_TRACE
+  latency_trace_attach(&disp_drv, &indev_drv);
+#endif
 
-  // ... (existing code) ...
+  timekeeping_init(10 * 3600 + 10 * 60); // 10:10:00 until set over Serial
 
   // ui_init();      // Comment out old UI
   my_ui_init(); // Initialize new Swipe UI & Clock
+  gesture_init(my_ui_flick);
+#if DISP_VSCROLL
+  disp_vscroll_attach(disp, my_ui_tileview());
+#endif
+#ifdef DISP_BENCH
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  Serial.printf("[ui] init=%luus lazy_tiles=%d lv_mem used=%lu peak=%lu\n",
+                my_ui_init_us(), UI_LAZY_TILES,
+                mon.total_size - mon.free_size, mon.max_used);
+#endif
 
+  idle_sched_init();
   Serial.println("Setup done");
   last_touch_time = millis(); // Initialize timer
 
@@ -243,16 +520,67 @@ void loop() {
   lv_tick_inc(current - lastTick);
   lastTick = current;
 
-  lv_timer_handler(); /* let the GUI do its work */
+  backlight_service();    /* fade completion callbacks */
+  serial_service();
+  if (timekeeping_take_alarm())
+    my_ui_clock_tick(); /* a clock hand must move */
+  touch_input_service(); /* fetch a touch sample if INT fired */
+  if (touch_input_available()) {
+    if (display_state != DISPLAY_ON)
+      set_display_state(DISPLAY_ON); // Wake up immediately
+    lv_timer_resume(indev->driver->read_timer);
+  }
 
-  // Auto Display Off Logic
-  if (is_display_on) {
-    // Turn off IF inactivity > 10s AND minimum ON duration > 10s
-    if ((current - last_touch_time > 10000) &&
-        (current - display_wake_time > 10000)) {
-      set_display_state(false);
+  DISP_TE_SERVICE(); /* deferred flush once its vblank has come */
+
+  uint32_t sleep_ms = IDLE_SLEEP_FOREVER;
+  if (display_state != DISPLAY_OFF)
+    sleep_ms = lv_timer_handler(); /* let the GUI do its work */
+
+  if (display_state == DISPLAY_ON) {
+    // Auto Display Off Logic
+    // Go to AOD (or off) IF inactivity > 10s AND minimum ON duration > 10s
+    uint32_t idle = current - last_touch_time;
+    uint32_t shown = current - display_wake_time;
+    if (idle > 10000 && shown > 10000) {
+      set_display_state(DISPLAY_IDLE_STATE);
+      // LVGL stays suspended while off; in AOD the clock was just re-armed
+      sleep_ms = (DISPLAY_IDLE_STATE == DISPLAY_OFF) ? IDLE_SLEEP_FOREVER : 0;
+    } else {
+      uint32_t off_in = 10000 - (idle < shown ? idle : shown) + 1;
+      if (off_in < sleep_ms)
+        sleep_ms = off_in;
     }
   }
 
-  delay(5);
+#ifdef DISP_BENCH
+  static uint32_t last_idle_report = 0;
+  if (current - last_idle_report >= 10000) {
+    last_idle_report = current;
+    idle_sched_stats_t st;
+    idle_sched_get_stats(&st);
+    Serial.printf("[idle] wakeups/s=%lu.%lu duty=%lu.%lu%% est=%luuA "
+                  "hand_redraws_avoided=%lu\n",
+                  st.wakeups_per_s_x10 / 10, st.wakeups_per_s_x10 % 10,
+                  st.duty_permille / 10, st.duty_permille % 10,
+                  st.est_current_ua, my_ui_clock_redraws_avoided());
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    Serial.printf("[ui] lv_mem used=%lu peak=%lu tile_cache=%luB\n",
+                  mon.total_size - mon.free_size, mon.max_used,
+                  tile_cache_bytes());
+  }
+  if (sleep_ms > 10000)
+    sleep_ms = 10000;
+#endif
+
+  if (touch_input_irq_pending() || touch_input_available())
+    sleep_ms = 0;
+#ifdef PERF_TRACE
+  // The cycle counter stops while the CPU sleeps; stay awake until the
+  // pixel DMA has finished so flush spans are not cut short.
+  if (disp_flush_busy())
+    sleep_ms = 0;
+#endif
+  idle_sched_sleep(sleep_ms);
 }
@@ -1,5 +1,9 @@
 #include "my_ui.h"
-#include <math.h>
+#include "clock_sprites.h"
+#include "tile_cache.h"
+#include "timekeeping.h"
+#include "touch_filter.h"
+#include "trig_q15.h"
 
 // UI Objects
 static lv_obj_t *tv; // Tileview
@@ -7,74 +11,214 @@ static lv_obj_t *lbl_hr;
 static lv_obj_t *lbl_batt;
 static lv_obj_t *lbl_steps;
 
-// Clock Hands
-static lv_obj_t *hour_hand;
-static lv_obj_t *min_hand;
-static lv_obj_t *sec_hand;
-
 // Clock center and radius
 #define CLOCK_CX 120
 #define CLOCK_CY 140
 #define CLOCK_R 100
 
+static lv_obj_t *face;
+
+#if !CLOCK_SPRITES
+// Clock Hands
+static lv_obj_t *hour_hand;
+static lv_obj_t *min_hand;
+static lv_obj_t *sec_hand;
+
 // Static point arrays for lines
 static lv_point_t hour_points[2];
 static lv_point_t min_points[2];
 static lv_point_t sec_points[2];
+#else
+// Back to front: hour, minute, second
+static clock_sprite_hand_t sprite_hands[3] = {
+    {&clock_sprite_hour, {}, -1},
+    {&clock_sprite_min, {}, -1},
+    {&clock_sprite_sec, {}, -1},
+};
+#endif
+
+// Hand render time for the DISP_BENCH report
+static uint32_t clock_render_us = 0;
+static uint32_t clock_ticks = 0;
 
 // Simulation Data
 static int val_hr = 72;
 static int val_steps = 1000;
 static int val_batt = 100;
 
+static void show_tile(uint8_t col, uint8_t row, lv_anim_enable_t anim);
+
 // Navigation Event Callback
 static void dashboard_nav_cb(lv_event_t *e) {
   intptr_t target = (intptr_t)lv_event_get_user_data(e);
 
   if (target == 0)
-    lv_obj_set_tile_id(tv, 0, 1, LV_ANIM_ON); // Battery -> Left
+    show_tile(0, 1, LV_ANIM_ON); // Battery -> Left
   else if (target == 1)
-    lv_obj_set_tile_id(tv, 2, 1, LV_ANIM_ON); // HR -> Right
+    show_tile(2, 1, LV_ANIM_ON); // HR -> Right
   else if (target == 2)
-    lv_obj_set_tile_id(tv, 1, 2, LV_ANIM_ON); // Steps -> Bottom
+    show_tile(1, 2, LV_ANIM_ON); // Steps -> Bottom
+}
+
+// Hand lengths
+#define HOUR_LEN (CLOCK_R - 40)
+#define MIN_LEN (CLOCK_R - 20)
+#define SEC_LEN (CLOCK_R - 10)
+
+// Longest look-ahead when searching for the next visible hand movement
+#define CLOCK_MAX_WAIT_S 3600
+
+static bool sec_hand_visible = true;
+static bool aod = false; // reduced face, whole minutes only
+static uint32_t clock_redraws_avoided = 0;
+
+// Hand angles (tenths of a degree, 0 = 12 o'clock) for a time of day.
+// 6 deg/s, 6 deg/min + 0.1 deg/s, 30 deg/h + 0.5 deg/min
+static void clock_hand_angles(uint32_t t_s, int32_t *sec, int32_t *min,
+                              int32_t *hour) {
+  if (aod)
+    t_s -= t_s % 60; // hands only step on the minute
+  int32_t s = t_s % 60;
+  int32_t m = (t_s / 60) % 60;
+  int32_t h = (t_s / 3600) % 12;
+
+  *sec = s * 60;
+  *min = m * 60 + s;
+  *hour = h * 300 + m * 5;
+}
+
+#if !CLOCK_SPRITES
+static lv_point_t hand_end(int32_t angle, int length) {
+  int32_t a = angle - 900; // 0 deg points right on screen
+  lv_point_t p;
+  p.x = CLOCK_CX + mul_q15(cos_q15(a), length);
+  p.y = CLOCK_CY + mul_q15(sin_q15(a), length);
+  return p;
 }
 
-// Helper to set line points based on angle
+static inline bool point_eq(lv_point_t a, lv_point_t b) {
+  return a.x == b.x && a.y == b.y;
+}
+
+// Helper to set line points based on angle. Skips the two invalidations
+// and the points update when the endpoint lands on the same pixel.
 static void update_hand_position(lv_obj_t *line, lv_point_t *points,
-                                 float angle_deg, int length) {
+                                 int32_t angle, int length) {
+  lv_point_t end = hand_end(angle, length);
+  if (point_eq(end, points[1])) {
+    clock_redraws_avoided++;
+    return;
+  }
+
   // Invalidate the OLD position before updating points
   lv_obj_invalidate(line);
 
-  float angle_rad = (angle_deg - 90.0f) * 3.14159f / 180.0f;
   points[0].x = CLOCK_CX;
   points[0].y = CLOCK_CY;
-  points[1].x = CLOCK_CX + (int)(cos(angle_rad) * length);
-  points[1].y = CLOCK_CY + (int)(sin(angle_rad) * length);
+  points[1] = end;
 
   lv_line_set_points(line, points, 2);
 
   // Invalidate the NEW position to ensure it gets drawn
   lv_obj_invalidate(line);
 }
+#endif
+
+enum { HAND_HOUR, HAND_MIN, HAND_SEC };
+static const int hand_len[] = {HOUR_LEN, MIN_LEN, SEC_LEN};
+
+// What ends up on screen for a hand at `angle`: the sprite index, or the
+// endpoint pixel of the lv_line hand.
+static int32_t hand_key(int hand, int32_t angle) {
+#if CLOCK_SPRITES
+  return angle * sprite_hands[hand].set->positions / TRIG_TURN;
+#else
+  lv_point_t p = hand_end(angle, hand_len[hand]);
+  return ((int32_t)p.x << 16) | (uint16_t)p.y;
+#endif
+}
 
-// Timer callback to update clock and data
+// Seconds from t_s until the first second at which a visible hand
+// changes on screen.
+static uint32_t clock_next_change(uint32_t t_s) {
+  int32_t sec, min, hour;
+  clock_hand_angles(t_s, &sec, &min, &hour);
+  int32_t sec_key = hand_key(HAND_SEC, sec);
+  int32_t min_key = hand_key(HAND_MIN, min);
+  int32_t hour_key = hand_key(HAND_HOUR, hour);
+
+  for (uint32_t k = 1; k < CLOCK_MAX_WAIT_S; k++) {
+    clock_hand_angles(t_s + k, &sec, &min, &hour);
+    if (sec_hand_visible && hand_key(HAND_SEC, sec) != sec_key)
+      return k;
+    if (hand_key(HAND_MIN, min) != min_key ||
+        hand_key(HAND_HOUR, hour) != hour_key)
+      return k;
+  }
+  return CLOCK_MAX_WAIT_S;
+}
+
+#if CLOCK_SPRITES
+static void update_sprite_hand(int hand, int32_t angle) {
+  if (!clock_sprites_set(face, &sprite_hands[hand], hand_key(hand, angle)))
+    clock_redraws_avoided++;
+}
+#endif
+
+// Move all visible hands to the given angles
+static void set_hands(int32_t sec, int32_t min, int32_t hour) {
+#if CLOCK_SPRITES
+  if (sec_hand_visible)
+    update_sprite_hand(HAND_SEC, sec);
+  update_sprite_hand(HAND_MIN, min);
+  update_sprite_hand(HAND_HOUR, hour);
+#else
+  if (sec_hand_visible)
+    update_hand_position(sec_hand, sec_points, sec, SEC_LEN);
+  update_hand_position(min_hand, min_points, min, MIN_LEN);
+  update_hand_position(hour_hand, hour_points, hour, HOUR_LEN);
+#endif
+}
+
+#if defined(DISP_BENCH) && !CLOCK_SPRITES
+// Times the lv_line draw of each hand
+static void hand_draw_bench_cb(lv_event_t *e) {
+  static uint32_t t0;
+  if (lv_event_get_code(e) == LV_EVENT_DRAW_MAIN_BEGIN)
+    t0 = micros();
+  else
+    clock_render_us += micros() - t0;
+}
+#endif
+
+// Slack on the fallback period in case the RTC alarm is lost (e.g. when the
+// time is set over Serial in between)
+#define CLOCK_ALARM_SLACK_MS 500
+
+static lv_timer_t *clock_timer;
+
+// Timer callback to update clock and data.
+// Runs only when a hand actually moves: the RTC alarm is armed for the next
+// second where an endpoint changes and readies this timer (my_ui_clock_tick).
 static void clock_timer_cb(lv_timer_t *timer) {
-  // 1. Update Clock (Start at 10:10:00)
-  uint32_t start_offset = (10 * 3600 + 10 * 60) * 1000;
-  uint32_t t = millis() + start_offset;
+  // 1. Update Clock
+  uint16_t ms;
+  uint32_t utc = timekeeping_now(&ms);
+  uint32_t t_s = utc + timekeeping_local_offset(utc);
 
-  float s = (t / 1000) % 60;
-  float m = ((t / 1000) / 60) % 60;
-  float h = ((t / 1000) / 3600) % 12;
+  int32_t sec, min, hour;
+  clock_hand_angles(t_s, &sec, &min, &hour);
+  set_hands(sec, min, hour);
+  clock_ticks++;
 
-  update_hand_position(sec_hand, sec_points, s * 6, CLOCK_R - 10);
-  update_hand_position(min_hand, min_points, m * 6 + s * 0.1f, CLOCK_R - 20);
-  update_hand_position(hour_hand, hour_points, h * 30 + m * 0.5f, CLOCK_R - 40);
+  uint32_t wait_s = clock_next_change(t_s);
+  timekeeping_arm(utc + wait_s);
+  lv_timer_set_period(timer, wait_s * 1000 - ms + CLOCK_ALARM_SLACK_MS);
 
   // 2. Update Simulation Data (Every 1 second approx)
   static uint32_t last_sec = 0;
-  if (t / 1000 != last_sec) {
-    last_sec = t / 1000;
+  if (t_s != last_sec) {
+    last_sec = t_s;
 
     // HR: Random 60-100
     val_hr = 60 + (rand() % 41);
@@ -111,7 +255,7 @@ static void create_data_widget(lv_obj_t *parent, int x, int y, int w, int h,
 
 static void create_dashboard(lv_obj_t *parent) {
   // 1. Analog Clock Face
-  lv_obj_t *face = lv_obj_create(parent);
+  face = lv_obj_create(parent);
   lv_obj_set_size(face, CLOCK_R * 2, CLOCK_R * 2);
   lv_obj_center(face);
   lv_obj_set_style_radius(face, LV_RADIUS_CIRCLE, 0);
@@ -124,6 +268,13 @@ static void create_dashboard(lv_obj_t *parent) {
   create_data_widget(parent, 70, 230, 100, 40, 2, &lbl_steps);
 
   // 3. Hands
+#if CLOCK_SPRITES
+  sprite_hands[0].color = lv_color_white();
+  sprite_hands[1].color = lv_color_hex(0xAAAAAA);
+  sprite_hands[2].color = lv_palette_main(LV_PALETTE_RED);
+  clock_sprites_attach(face, sprite_hands, 3);
+  set_hands(0, 0, 0);
+#else
   static lv_style_t style_thick;
   lv_style_init(&style_thick);
   lv_style_set_line_width(&style_thick, 6);
@@ -149,17 +300,31 @@ static void create_dashboard(lv_obj_t *parent) {
   lv_obj_set_style_line_color(sec_hand, lv_palette_main(LV_PALETTE_RED), 0);
   lv_line_set_points(sec_hand, sec_points, 2);
 
-  update_hand_position(hour_hand, hour_points, 0, CLOCK_R - 40);
-  update_hand_position(min_hand, min_points, 0, CLOCK_R - 20);
-  update_hand_position(sec_hand, sec_points, 0, CLOCK_R - 10);
+#ifdef DISP_BENCH
+  lv_obj_t *hands[] = {hour_hand, min_hand, sec_hand};
+  for (lv_obj_t *h : hands) {
+    lv_obj_add_event_cb(h, hand_draw_bench_cb, LV_EVENT_DRAW_MAIN_BEGIN, NULL);
+    lv_obj_add_event_cb(h, hand_draw_bench_cb, LV_EVENT_DRAW_MAIN_END, NULL);
+  }
+#endif
 
-  lv_timer_create(clock_timer_cb, 50, NULL);
+  update_hand_position(hour_hand, hour_points, 0, HOUR_LEN);
+  update_hand_position(min_hand, min_points, 0, MIN_LEN);
+  update_hand_position(sec_hand, sec_points, 0, SEC_LEN);
+#endif
+
+  clock_timer = lv_timer_create(clock_timer_cb, 1000, NULL);
+  lv_timer_ready(clock_timer);
 }
 
+// Kept here so a rebuilt settings tile shows the current value
+static int brightness_val = 255;
+
 // Slider Event Callback
 static void slider_event_cb(lv_event_t *e) {
   lv_obj_t *slider = lv_event_get_target(e);
   int val = (int)lv_slider_get_value(slider);
+  brightness_val = val;
 
   // Call main.cpp function to update brightness
   update_user_brightness(val);
@@ -180,8 +345,8 @@ static void create_settings_screen(lv_obj_t *parent) {
   lv_obj_t *slider = lv_slider_create(parent);
   lv_obj_set_width(slider, 180);
   lv_obj_center(slider);
-  lv_slider_set_range(slider, 10, 255);          // Min 10 to prevent blackout
-  lv_slider_set_value(slider, 255, LV_ANIM_OFF); // Default max
+  lv_slider_set_range(slider, 10, 255); // Min 10 to prevent blackout
+  lv_slider_set_value(slider, brightness_val, LV_ANIM_OFF);
   lv_obj_add_event_cb(slider, slider_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
 
   // Label "Brightness"
@@ -196,42 +361,274 @@ static void create_settings_screen(lv_obj_t *parent) {
   lv_obj_align_to(icon, slider, LV_ALIGN_OUT_BOTTOM_MID, 0, 10);
 }
 
+static void create_detail_tile(lv_obj_t *parent, const char *text,
+                               lv_palette_t color) {
+  lv_obj_t *lbl = lv_label_create(parent);
+  lv_label_set_text(lbl, text);
+  lv_obj_center(lbl);
+  lv_obj_set_style_bg_color(parent, lv_palette_main(color), 0);
+  lv_obj_set_style_bg_opa(parent, LV_OPA_COVER, 0);
+}
+
+static void create_steps_tile(lv_obj_t *parent) {
+  create_detail_tile(parent, "Steps Details\n\n- Today: 12345\n- Goal: 10000",
+                     LV_PALETTE_GREEN);
+}
+
+static void create_battery_tile(lv_obj_t *parent) {
+  create_detail_tile(parent, "Battery Status\n\n- Level: 85%\n- Charging: No",
+                     LV_PALETTE_ORANGE);
+}
+
+static void create_hr_tile(lv_obj_t *parent) {
+  create_detail_tile(parent, "Heart Rate\n\n- Avg: 72 bpm\n- Max: 120 bpm",
+                     LV_PALETTE_PURPLE);
+}
+
+// Tiles other than the dashboard get their content when a scroll towards
+// them begins. Once the LVGL heap use passes UI_TILE_MEM_BUDGET, content of
+// tiles two hops away from the shown one is dropped again. Static tiles
+// are drawn from a snapshot while the tileview scrolls (UI_TILE_CACHE).
+typedef struct {
+  uint8_t col, row;
+  lv_dir_t dir;
+  void (*build)(lv_obj_t *tile);
+  bool is_static;
+  lv_obj_t *obj;
+  bool built;
+} ui_tile_t;
+
+static ui_tile_t tiles[] = {
+    {1, 1, LV_DIR_ALL, create_dashboard, false, NULL, false},          // Center
+    {1, 0, LV_DIR_BOTTOM, create_settings_screen, false, NULL, false}, // Top
+    {1, 2, LV_DIR_TOP, create_steps_tile, true, NULL, false},          // Bottom
+    {0, 1, LV_DIR_RIGHT, create_battery_tile, true, NULL, false},      // Left
+    {2, 1, LV_DIR_LEFT, create_hr_tile, true, NULL, false},            // Right
+};
+#define TILE_COUNT (sizeof(tiles) / sizeof(tiles[0]))
+
+static uint32_t init_us = 0;
+
+static uint32_t ui_mem_used(void) {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  return mon.total_size - mon.free_size;
+}
+
+static ui_tile_t *tile_at(int col, int row) {
+  for (uint32_t i = 0; i < TILE_COUNT; i++)
+    if (tiles[i].col == col && tiles[i].row == row)
+      return &tiles[i];
+  return NULL;
+}
+
+static ui_tile_t *tile_of(const lv_obj_t *obj) {
+  for (uint32_t i = 0; i < TILE_COUNT; i++)
+    if (tiles[i].obj == obj)
+      return &tiles[i];
+  return NULL;
+}
+
+static void tile_build(ui_tile_t *t) {
+  if (t == NULL || t->built)
+    return;
+  t->build(t->obj);
+  t->built = true;
+}
+
+static void show_tile(uint8_t col, uint8_t row, lv_anim_enable_t anim) {
+  tile_build(tile_at(col, row));
+  lv_obj_set_tile_id(tv, col, row, anim);
+}
+
+// Build the tile the finger is dragging into view
+static void tv_scroll_build(void) {
+  lv_indev_t *indev = lv_indev_get_act();
+  ui_tile_t *cur = tile_of(lv_tileview_get_tile_act(tv));
+  if (indev == NULL || cur == NULL)
+    return; // programmatic scroll: show_tile() built the target
+
+  lv_point_t v;
+  lv_indev_get_vect(indev, &v);
+  lv_dir_t dir = lv_indev_get_scroll_dir(indev);
+
+  // Finger moving left reveals the tile on the right, and so on
+  if (dir & LV_DIR_HOR) {
+    if (v.x <= 0)
+      tile_build(tile_at(cur->col + 1, cur->row));
+    if (v.x >= 0)
+      tile_build(tile_at(cur->col - 1, cur->row));
+  }
+  if (dir & LV_DIR_VER) {
+    if (v.y <= 0)
+      tile_build(tile_at(cur->col, cur->row + 1));
+    if (v.y >= 0)
+      tile_build(tile_at(cur->col, cur->row - 1));
+  }
+}
+
+static void tv_scroll_begin_cb(lv_event_t *e) {
+  tv_scroll_build();
+#if UI_TILE_CACHE
+  tile_cache_begin();
+#endif
+}
+
+#if UI_TILE_CACHE
+static void tv_scroll_end_cb(lv_event_t *e) { tile_cache_end(); }
+#endif
+
+// Tile settled: drop far tiles if the heap is over budget
+static void tv_tile_changed_cb(lv_event_t *e) {
+  ui_tile_t *cur = tile_of(lv_tileview_get_tile_act(tv));
+  if (cur == NULL || ui_mem_used() <= UI_TILE_MEM_BUDGET)
+    return;
+
+  for (uint32_t i = 1; i < TILE_COUNT; i++) { // the dashboard always stays
+    ui_tile_t *t = &tiles[i];
+    int hops = abs(t->col - cur->col) + abs(t->row - cur->row);
+    if (t->built && hops >= 2) {
+#if UI_TILE_CACHE
+      tile_cache_invalidate(t->obj);
+#endif
+      lv_obj_clean(t->obj);
+      t->built = false;
+    }
+  }
+}
+
 void my_ui_init(void) {
+  uint32_t t0 = micros();
+
   tv = lv_tileview_create(lv_scr_act());
   lv_obj_set_style_bg_color(tv, lv_color_black(), 0);
+  lv_obj_add_event_cb(tv, tv_scroll_begin_cb, LV_EVENT_SCROLL_BEGIN, NULL);
+  lv_obj_add_event_cb(tv, tv_tile_changed_cb, LV_EVENT_VALUE_CHANGED, NULL);
+#if UI_TILE_CACHE
+  lv_obj_add_event_cb(tv, tv_scroll_end_cb, LV_EVENT_SCROLL_END, NULL);
+#endif
+
+  for (uint32_t i = 0; i < TILE_COUNT; i++) {
+    ui_tile_t *t = &tiles[i];
+    t->obj = lv_tileview_add_tile(tv, t->col, t->row, t->dir);
+#if UI_TILE_CACHE
+    if (t->is_static)
+      tile_cache_enable(t->obj);
+#endif
+    if (i == 0 || !UI_LAZY_TILES)
+      tile_build(t);
+  }
 
-  // Tile 1: Center (Dashboard)
-  lv_obj_t *tile_center = lv_tileview_add_tile(tv, 1, 1, LV_DIR_ALL);
-  create_dashboard(tile_center);
+  // Initial Tile
+  lv_obj_set_tile(tv, tiles[0].obj, LV_ANIM_OFF);
 
-  // Tile 2: Top (Settings)
-  lv_obj_t *tile_top = lv_tileview_add_tile(tv, 1, 0, LV_DIR_BOTTOM);
-  create_settings_screen(tile_top);
+#if TOUCH_FILTER
+  // Strokes that reach LVGL here are mostly tileview drags
+  static const touch_filter_cfg_t drag_cfg = TOUCH_FILTER_CFG_DRAG;
+  touch_filter_set_config(lv_scr_act(), &drag_cfg);
+#endif
 
-  // Tile 3: Bottom (Steps Details)
-  lv_obj_t *tile_bottom = lv_tileview_add_tile(tv, 1, 2, LV_DIR_TOP);
-  lv_obj_t *lbl = lv_label_create(tile_bottom);
-  lv_label_set_text(lbl, "Steps Details\n\n- Today: 12345\n- Goal: 10000");
-  lv_obj_center(lbl);
-  lv_obj_set_style_bg_color(tile_bottom, lv_palette_main(LV_PALETTE_GREEN), 0);
-  lv_obj_set_style_bg_opa(tile_bottom, LV_OPA_COVER, 0);
+  init_us = micros() - t0;
+}
 
-  // Tile 4: Left (Battery Details)
-  lv_obj_t *tile_left = lv_tileview_add_tile(tv, 0, 1, LV_DIR_RIGHT);
-  lbl = lv_label_create(tile_left);
-  lv_label_set_text(lbl, "Battery Status\n\n- Level: 85%\n- Charging: No");
-  lv_obj_center(lbl);
-  lv_obj_set_style_bg_color(tile_left, lv_palette_main(LV_PALETTE_ORANGE), 0);
-  lv_obj_set_style_bg_opa(tile_left, LV_OPA_COVER, 0);
+lv_obj_t *my_ui_tileview(void) { return tv; }
+
+bool my_ui_flick(lv_dir_t finger) {
+  ui_tile_t *cur = tile_of(lv_tileview_get_tile_act(tv));
+  if (cur == NULL)
+    return false;
+
+  // Same mapping as dragging: a finger moving left reveals the right tile,
+  // which the current tile must allow scrolling towards
+  int col = cur->col, row = cur->row;
+  lv_dir_t towards;
+  switch (finger) {
+  case LV_DIR_LEFT:
+    col++;
+    towards = LV_DIR_RIGHT;
+    break;
+  case LV_DIR_RIGHT:
+    col--;
+    towards = LV_DIR_LEFT;
+    break;
+  case LV_DIR_TOP:
+    row++;
+    towards = LV_DIR_BOTTOM;
+    break;
+  case LV_DIR_BOTTOM:
+    row--;
+    towards = LV_DIR_TOP;
+    break;
+  default:
+    return false;
+  }
+  if (!(cur->dir & towards) || tile_at(col, row) == NULL)
+    return false;
 
-  // Tile 5: Right (HR Details)
-  lv_obj_t *tile_right = lv_tileview_add_tile(tv, 2, 1, LV_DIR_LEFT);
-  lbl = lv_label_create(tile_right);
-  lv_label_set_text(lbl, "Heart Rate\n\n- Avg: 72 bpm\n- Max: 120 bpm");
-  lv_obj_center(lbl);
-  lv_obj_set_style_bg_color(tile_right, lv_palette_main(LV_PALETTE_PURPLE), 0);
-  lv_obj_set_style_bg_opa(tile_right, LV_OPA_COVER, 0);
+  show_tile(col, row, LV_ANIM_ON);
+  return true;
+}
 
-  // Initial Tile
-  lv_obj_set_tile(tv, tile_center, LV_ANIM_OFF);
+bool my_ui_tile_id(uint8_t *col, uint8_t *row) {
+  ui_tile_t *cur = tile_of(lv_tileview_get_tile_act(tv));
+  if (cur == NULL)
+    return false;
+  *col = cur->col;
+  *row = cur->row;
+  return true;
+}
+
+uint32_t my_ui_init_us(void) { return init_us; }
+
+uint32_t my_ui_clock_redraws_avoided(void) { return clock_redraws_avoided; }
+
+uint32_t my_ui_clock_render_us(uint32_t *ticks) {
+#if CLOCK_SPRITES
+  clock_render_us = clock_sprites_render_us();
+#endif
+  static uint32_t last_us = 0;
+  uint32_t us = clock_render_us - last_us;
+  last_us = clock_render_us;
+  *ticks = clock_ticks;
+  clock_ticks = 0;
+  return us;
+}
+
+void my_ui_set_aod(bool on, lv_area_t *live) {
+  aod = on;
+  sec_hand_visible = !on;
+
+  if (on)
+    lv_obj_set_tile_id(tv, 1, 1, LV_ANIM_OFF);
+
+  lv_obj_t *widgets[] = {lv_obj_get_parent(lbl_hr),
+                         lv_obj_get_parent(lbl_batt),
+                         lv_obj_get_parent(lbl_steps)};
+  for (lv_obj_t *w : widgets) {
+    if (on)
+      lv_obj_add_flag(w, LV_OBJ_FLAG_HIDDEN);
+    else
+      lv_obj_clear_flag(w, LV_OBJ_FLAG_HIDDEN);
+  }
+
+#if CLOCK_SPRITES
+  if (on)
+    clock_sprites_set(face, &sprite_hands[HAND_SEC], -1);
+#else
+  if (on)
+    lv_obj_add_flag(sec_hand, LV_OBJ_FLAG_HIDDEN);
+  else
+    lv_obj_clear_flag(sec_hand, LV_OBJ_FLAG_HIDDEN);
+#endif
+
+  // Re-quantise the hands and re-arm the alarm for the new step size
+  clock_timer_cb(clock_timer);
+
+  lv_obj_update_layout(face);
+  lv_obj_get_coords(face, live);
+}
+
+void my_ui_clock_tick(void) {
+  if (clock_timer)
+    lv_timer_ready(clock_timer);
 }
@@ -0,0 +1,186 @@
+#include "perf_trace.h"
+#include "histo.h"
+
+#ifdef PERF_TRACE
+#include <Arduino.h>
+#include <stddef.h>
+
+// One record per refresh that flushed something. The render side closes in
+// perf_trace_refr_end() on the main loop, the flush side when the last area
+// of the refresh leaves the bus (SPIM interrupt); whichever comes second
+// commits the record to the ring. A refresh that begins while the previous
+// one's last area is still out parks that record; the next flush end is
+// its own (LVGL flushes one area at a time) and commits it.
+
+#define PERF_CPU_MHZ 64
+
+static perf_trace_rec_t ring[PERF_TRACE_DEPTH];
+static uint32_t ring_head = 0;  // next slot to write
+static uint32_t ring_count = 0; // valid records, saturates at DEPTH
+
+static perf_trace_rec_t cur;
+static uint32_t refr_t0 = 0;
+static uint32_t flush_t0 = 0;
+static uint32_t wait_cyc = 0;
+static volatile bool in_refr = false;
+static volatile bool last_queued = false; // last area of the refresh started
+static volatile bool last_done = false;   // ...and completed
+static perf_trace_rec_t parked;           // render side done, flush pending
+static uint32_t parked_flush_t0 = 0;
+static volatile bool parked_open = false;
+
+uint32_t perf_cycles(void) {
+#if defined(NRF52840_XXAA)
+  return DWT->CYCCNT;
+#else
+  return micros() * PERF_CPU_MHZ;
+#endif
+}
+
+void perf_trace_init(void) {
+#if defined(NRF52840_XXAA)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+static void commit(const perf_trace_rec_t *rec) {
+  ring[ring_head] = *rec;
+  ring_head = (ring_head + 1) % PERF_TRACE_DEPTH;
+  if (ring_count < PERF_TRACE_DEPTH)
+    ring_count++;
+}
+
+void perf_trace_refr_begin(void) {
+  noInterrupts();
+  // The previous refresh may still have its last area on the wire (or held
+  // for the vblank); a record parked earlier and never finished is dropped
+  if (last_queued && !last_done) {
+    parked = cur;
+    parked_flush_t0 = flush_t0;
+    parked_open = true;
+  }
+  cur = perf_trace_rec_t();
+  last_queued = false;
+  last_done = false;
+  in_refr = true;
+  interrupts();
+
+  wait_cyc = 0;
+  refr_t0 = perf_cycles();
+}
+
+void perf_trace_refr_end(void) {
+  uint32_t span = perf_cycles() - refr_t0;
+  if (cur.areas == 0) {
+    in_refr = false;
+    return;
+  }
+  cur.render_cyc = span - wait_cyc;
+
+  noInterrupts();
+  in_refr = false;
+  if (last_done)
+    commit(&cur);
+  interrupts();
+}
+
+void perf_trace_flush_begin(uint32_t bytes, bool last) {
+  if (!in_refr)
+    return;
+  if (cur.areas == 0)
+    flush_t0 = perf_cycles();
+  cur.areas++;
+  cur.px += bytes / 2;
+  cur.spi_bytes += bytes + PERF_AREA_CMD_BYTES;
+  if (last)
+    last_queued = true;
+}
+
+void perf_trace_flush_end(void) {
+  if (parked_open) {
+    parked.flush_cyc = perf_cycles() - parked_flush_t0;
+    parked_open = false;
+    commit(&parked);
+    return;
+  }
+  if (!last_queued || last_done)
+    return;
+  cur.flush_cyc = perf_cycles() - flush_t0;
+  last_done = true;
+  if (!in_refr)
+    commit(&cur);
+}
+
+void perf_trace_wait(uint32_t cycles) {
+  if (in_refr)
+    wait_cyc += cycles;
+}
+
+// Copies one field of every record, scaled down by `div`
+static uint32_t collect(uint32_t *out, size_t offset, size_t size,
+                        uint32_t div) {
+  noInterrupts();
+  uint32_t n = ring_count;
+  for (uint32_t i = 0; i < n; i++) {
+    const uint8_t *field = (const uint8_t *)&ring[i] + offset;
+    out[i] = (size == sizeof(uint16_t)) ? *(const uint16_t *)field
+                                        : *(const uint32_t *)field;
+  }
+  interrupts();
+
+  for (uint32_t i = 0; i < n; i++)
+    out[i] /= div;
+  histo_sort(out, n);
+  return n;
+}
+
+#define PERF_COLLECT(out, field, div)                                         \
+  collect(out, offsetof(perf_trace_rec_t, field),                             \
+          sizeof(((perf_trace_rec_t *)0)->field), div)
+
+static void print_row(const char *name, const char *unit, const uint32_t *v,
+                      uint32_t n) {
+  Serial.printf("[perf] %-8s p50=%lu p95=%lu p99=%lu max=%lu %s\n", name,
+                (unsigned long)histo_pct(v, n, 50),
+                (unsigned long)histo_pct(v, n, 95),
+                (unsigned long)histo_pct(v, n, 99), (unsigned long)v[n - 1],
+                unit);
+}
+
+void perf_trace_dump(void) {
+  static uint32_t v[PERF_TRACE_DEPTH];
+  uint32_t n;
+
+  if (ring_count == 0) {
+    Serial.printf("[perf] no refreshes recorded\n");
+    return;
+  }
+
+  n = PERF_COLLECT(v, render_cyc, PERF_CPU_MHZ);
+  Serial.printf("[perf] last %lu refreshes\n", (unsigned long)n);
+  print_row("render", "us", v, n);
+
+  uint64_t flush_us = 0;
+  n = PERF_COLLECT(v, flush_cyc, PERF_CPU_MHZ);
+  for (uint32_t i = 0; i < n; i++)
+    flush_us += v[i];
+  print_row("flush", "us", v, n);
+
+  n = PERF_COLLECT(v, px, 1);
+  print_row("pixels", "", v, n);
+  n = PERF_COLLECT(v, areas, 1);
+  print_row("areas", "", v, n);
+
+  uint64_t bytes = 0;
+  n = PERF_COLLECT(v, spi_bytes, 1);
+  for (uint32_t i = 0; i < n; i++)
+    bytes += v[i];
+  print_row("spi", "B", v, n);
+
+  if (flush_us > 0)
+    Serial.printf("[perf] flush throughput=%lu kB/s\n",
+                  (unsigned long)(bytes * 1000 / flush_us / 1024));
+}
+#endif
@@ -0,0 +1,59 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// Minimal Arduino API for the native simulator build (env:native).
+// millis() is simulated time, advanced only by the simulator loop, so runs
+// are reproducible. micros() is the host's monotonic clock and is meant for
+// measuring render cost.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+typedef void (*voidFuncPtr)(void);
+
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+static inline void pinMode(uint32_t pin, uint32_t mode) {
+  (void)pin;
+  (void)mode;
+}
+static inline void noInterrupts(void) {}
+static inline void interrupts(void) {}
+
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint32_t pin, voidFuncPtr callback, uint32_t mode);
+void detachInterrupt(uint32_t pin);
+
+class SimSerial {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  int available(void) { return 0; }
+  int read(void) { return -1; }
+  int printf(const char *fmt, ...);
+  void println(const char *s) { ::printf("%s\n", s); }
+};
+
+extern SimSerial Serial;
+
+// Advance simulated time (millis, LVGL tick, fake RTC)
+void sim_advance_ms(uint32_t ms);
+
+// Run the handler attached to `pin`, as its edge would
+void sim_fire_interrupt(uint32_t pin);
+
+#endif
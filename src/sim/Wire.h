@@ -0,0 +1,37 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+// Minimal TwoWire for the native build. Writes are ignored; reads return
+// the bytes queued with feed(), as if the CST816S had answered them.
+
+#include <stdint.h>
+
+class TwoWire {
+public:
+  void begin(void) {}
+  void end(void) {}
+  void setClock(uint32_t hz) { (void)hz; }
+  void beginTransmission(uint8_t addr) { (void)addr; }
+  uint8_t write(uint8_t b) {
+    (void)b;
+    return 1;
+  }
+  uint8_t endTransmission(bool stop = true) {
+    (void)stop;
+    return nack;
+  }
+  uint8_t requestFrom(uint8_t addr, uint8_t len);
+  int read(void);
+
+  // Answer the next reads with `data`
+  void feed(const uint8_t *data, uint8_t len);
+  uint8_t nack = 0; // endTransmission() result
+
+private:
+  uint8_t rx[64];
+  uint8_t rx_len = 0, rx_pos = 0, avail = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
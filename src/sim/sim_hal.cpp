@@ -0,0 +1,79 @@
+#include "Arduino.h"
+#include "Wire.h"
+#include "idle_sched.h"
+#include "timekeeping.h"
+#include <lvgl.h>
+#include <stdarg.h>
+#include <time.h>
+
+#define SIM_PINS 48 // P0.00 .. P1.15
+
+SimSerial Serial;
+TwoWire Wire;
+
+static uint32_t sim_ms = 0;
+static voidFuncPtr pin_isr[SIM_PINS];
+
+uint32_t millis(void) { return sim_ms; }
+
+uint32_t micros(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+void delay(uint32_t ms) { sim_advance_ms(ms); }
+
+void attachInterrupt(uint32_t pin, voidFuncPtr callback, uint32_t mode) {
+  (void)mode;
+  if (pin < SIM_PINS)
+    pin_isr[pin] = callback;
+}
+
+void detachInterrupt(uint32_t pin) {
+  if (pin < SIM_PINS)
+    pin_isr[pin] = NULL;
+}
+
+void sim_fire_interrupt(uint32_t pin) {
+  if (pin < SIM_PINS && pin_isr[pin])
+    pin_isr[pin]();
+}
+
+void idle_sched_wake_from_isr(void) {}
+
+void TwoWire::feed(const uint8_t *data, uint8_t len) {
+  for (uint8_t i = 0; i < len && rx_len < sizeof(rx); i++)
+    rx[rx_len++] = data[i];
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t len) {
+  (void)addr;
+  // Bytes not read from the last answer are gone, as on the bus
+  memmove(rx, rx + rx_pos, rx_len - rx_pos);
+  rx_len -= rx_pos;
+  rx_pos = 0;
+  avail = len < rx_len ? len : rx_len;
+  return avail;
+}
+
+int TwoWire::read(void) {
+  if (avail == 0)
+    return -1;
+  avail--;
+  return rx[rx_pos++];
+}
+
+void sim_advance_ms(uint32_t ms) {
+  sim_ms += ms;
+  lv_tick_inc(ms);
+  timekeeping_fake_advance_ms(ms);
+}
+
+int SimSerial::printf(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vprintf(fmt, ap);
+  va_end(ap);
+  return n;
+}
@@ -0,0 +1,296 @@
+// Headless simulator (env:native).
+// Runs my_ui on a 240x280 RGB565 in-memory panel with simulated time and a
+// scripted touch stream, and dumps frames as PPM. Time only advances when
+// LVGL has nothing to do, so a run is deterministic and renders the same
+// frames on every host.
+//
+//   sim [-t run_ms] [-s touch_script] [-o dump_prefix] [-e dump_every_ms]
+//
+// Touch scripts are described in sim_script.h. Samples go through the
+// flick recognizer (gesture.h) and the touch filter as on the device;
+// `expect` lines are checked by test/test_gestures, and the filter's lag
+// and jitter by test/test_touch_filter. The colour byte order on the wire
+// is checked by test/test_color_order.
+
+#include "Arduino.h"
+#include "disp_coalesce.h"
+#include "disp_flush.h"
+#include "disp_vscroll.h"
+#include "gesture.h"
+#include "latency_trace.h"
+#include "my_ui.h"
+#include "perf_trace.h"
+#include "sim_script.h"
+#include "tile_cache.h"
+#include "timekeeping.h"
+#include "touch_filter.h"
+#include <algorithm>
+#include <lvgl.h>
+#include <unistd.h>
+#include <vector>
+
+#define SIM_HOR_RES 240
+#define SIM_VER_RES 280
+#define SIM_BUF_PIXELS (SIM_HOR_RES * SIM_VER_RES / 10) // DISP_BUF_TENTH
+
+// Panel RAM, stored as the bytes that went over the bus
+static uint8_t panel[SIM_HOR_RES * SIM_VER_RES * 2];
+static lv_area_t window;
+static uint32_t window_pos; // bytes written into the current window
+
+static lv_disp_draw_buf_t draw_buf;
+static lv_color_t buf1[SIM_BUF_PIXELS];
+static lv_color_t buf2[SIM_BUF_PIXELS];
+
+static sim_script_t script;
+static size_t script_pos = 0;
+static bool touch_fresh = false; // applied, not yet read by LVGL
+
+static uint32_t frames = 0;
+static uint64_t bus_bytes = 0; // pixel payload + address window commands
+static uint32_t brightness = 255;
+
+void update_user_brightness(int val) { brightness = val; }
+
+// Memory backend for disp_flush: copies each chunk into the address window
+// like the panel's RAMWR would and completes immediately.
+static void panel_start(const uint8_t *ptr, uint16_t len, bool first) {
+  static const uint8_t *src;
+  if (first) {
+    src = ptr;
+    window_pos = 0;
+  }
+
+  lv_coord_t w = lv_area_get_width(&window);
+  for (uint32_t i = 0; i < len; i += 2, window_pos += 2) {
+    uint32_t px = window_pos / 2;
+    uint32_t x = window.x1 + px % w;
+    uint32_t y = window.y1 + px / w;
+    uint32_t at = (y * SIM_HOR_RES + x) * 2;
+    panel[at] = src[i];
+    panel[at + 1] = src[i + 1];
+  }
+  src += len;
+  disp_flush_chunk_done();
+}
+
+static void panel_finish(void) {}
+
+static const disp_flush_backend_t panel_backend = {panel_start, panel_finish};
+
+static void sim_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area,
+                           lv_color_t *color_p) {
+  DISP_VSCROLL_BEFORE_FLUSH();
+  window = *area;
+  window.y1 = DISP_VSCROLL_ROW(area->y1);
+  window.y2 = DISP_VSCROLL_ROW(area->y2);
+  bus_bytes += lv_area_get_size(area) * 2 + PERF_AREA_CMD_BYTES;
+  disp_flush_start(disp, (const uint8_t *)&color_p->full,
+                   lv_area_get_size(area) * 2);
+}
+
+static void sim_monitor(lv_disp_drv_t *disp, uint32_t time, uint32_t px) {
+  (void)disp;
+  (void)time;
+  (void)px;
+  frames++;
+}
+
+// Applied script samples were fed to the recognizer; LVGL reads what it
+// lets through, smoothed and predicted (touch_filter.h)
+static void sim_touch_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+  (void)drv;
+#if TOUCH_FILTER
+  static touch_filter_t filter;
+#endif
+  static gesture_point_t last = {{0, 0}, false, 0};
+  static lv_point_t shown = {0, 0};
+  if (touch_fresh) {
+    touch_fresh = false;
+    LAT_TRACE_READ();
+  }
+  gesture_poll(millis());
+  if (gesture_pop(&last)) {
+    data->continue_reading = gesture_pending();
+    shown = last.point;
+#if TOUCH_FILTER
+    touch_filter_apply(&filter, &shown, last.pressed, last.t_ms, millis());
+#endif
+  }
+  data->point = shown;
+  data->state = last.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+}
+
+// Screen pixel `i` as RGB565 (the panel receives big-endian), read through
+// the panel's vertical scroll offset
+static inline uint16_t panel_pixel(uint32_t i) {
+  uint32_t at = DISP_VSCROLL_ROW(i / SIM_HOR_RES) * SIM_HOR_RES +
+                i % SIM_HOR_RES;
+  return (panel[at * 2] << 8) | panel[at * 2 + 1];
+}
+
+static bool dump_ppm(const char *prefix, uint32_t t_ms) {
+  char path[256];
+  snprintf(path, sizeof(path), "%s_%06u.ppm", prefix, (unsigned)t_ms);
+  FILE *f = fopen(path, "wb");
+  if (f == NULL)
+    return false;
+
+  fprintf(f, "P6\n%d %d\n255\n", SIM_HOR_RES, SIM_VER_RES);
+  for (uint32_t i = 0; i < SIM_HOR_RES * SIM_VER_RES; i++) {
+    uint16_t c = panel_pixel(i);
+    uint8_t rgb[3] = {(uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+                      (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+                      (uint8_t)((c & 0x1F) * 255 / 31)};
+    fwrite(rgb, 1, 3, f);
+  }
+  fclose(f);
+  return true;
+}
+
+// Host tests (test/) link the simulator sources but bring their own main()
+#ifndef PIO_UNIT_TESTING
+int main(int argc, char **argv) {
+  uint32_t run_ms = 5000;
+  uint32_t dump_every = 0;
+  const char *prefix = NULL;
+  const char *script_path = NULL;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "t:s:o:e:")) != -1) {
+    switch (opt) {
+    case 't':
+      run_ms = strtoul(optarg, NULL, 10);
+      break;
+    case 's':
+      script_path = optarg;
+      break;
+    case 'o':
+      prefix = optarg;
+      break;
+    case 'e':
+      dump_every = strtoul(optarg, NULL, 10);
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [-t run_ms] [-s touch_script] [-o dump_prefix] "
+              "[-e dump_every_ms]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (script_path && !sim_script_load(script_path, &script)) {
+    fprintf(stderr, "sim: cannot read %s\n", script_path);
+    return 1;
+  }
+
+  lv_init();
+  PERF_TRACE_INIT();
+  disp_flush_init(&panel_backend);
+  lv_disp_draw_buf_init(&draw_buf, buf1, buf2, SIM_BUF_PIXELS);
+
+  static lv_disp_drv_t disp_drv;
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = SIM_HOR_RES;
+  disp_drv.ver_res = SIM_VER_RES;
+  disp_drv.flush_cb = sim_disp_flush;
+  disp_drv.monitor_cb = sim_monitor;
+  disp_drv.draw_buf = &draw_buf;
+  lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+  disp_coalesce_init(disp);
+
+  static lv_indev_drv_t indev_drv;
+  lv_indev_drv_init(&indev_drv);
+  indev_drv.type = LV_INDEV_TYPE_POINTER;
+  indev_drv.read_cb = sim_touch_read;
+  lv_indev_drv_register(&indev_drv);
+#ifdef LATENCY_TRACE
+  latency_trace_attach(&disp_drv, &indev_drv);
+#endif
+
+  timekeeping_init(10 * 3600 + 10 * 60); // same start as the device
+  my_ui_init();
+  gesture_init(my_ui_flick);
+#if DISP_VSCROLL
+  disp_vscroll_attach(disp, my_ui_tileview());
+#endif
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  printf("[sim] ui init=%uus lazy_tiles=%d lv_mem used=%u\n",
+         (unsigned)my_ui_init_us(), UI_LAZY_TILES,
+         (unsigned)(mon.total_size - mon.free_size));
+
+  uint64_t render_us = 0;
+  uint32_t render_max_us = 0;
+  uint32_t next_dump = 0;
+  const std::vector<sim_touch_t> &touches = script.touches;
+
+  for (;;) {
+    uint32_t now = millis();
+
+    while (script_pos < touches.size() && touches[script_pos].t_ms <= now) {
+      const sim_touch_t *touch = &touches[script_pos++];
+      touch_fresh = true;
+      LAT_TRACE_IRQ(); // the controller would raise INT here
+      touch_sample_t s = sim_script_sample(touch, 0, 0);
+      gesture_feed(&s);
+    }
+    if (timekeeping_take_alarm())
+      my_ui_clock_tick();
+
+    uint32_t before = frames;
+    uint32_t t0 = micros();
+    uint32_t wait = lv_timer_handler();
+    uint32_t spent = micros() - t0;
+    if (frames != before) {
+      render_us += spent;
+      if (spent > render_max_us)
+        render_max_us = spent;
+    }
+
+    if (prefix && dump_every && now >= next_dump) {
+      dump_ppm(prefix, now);
+      next_dump = now + dump_every;
+    }
+    if (now >= run_ms)
+      break;
+
+    // Jump to the next thing that can change the screen
+    uint32_t step = wait;
+    if (script_pos < touches.size())
+      step = std::min(step, touches[script_pos].t_ms - now);
+    if (prefix && dump_every)
+      step = std::min(step, next_dump - now);
+    step = std::min(step, run_ms - now);
+    sim_advance_ms(std::max<uint32_t>(step, 1));
+  }
+
+  if (prefix)
+    dump_ppm(prefix, millis());
+
+  lv_mem_monitor(&mon);
+  printf("[sim] %ums simulated, %u frames, render avg=%uus max=%uus, "
+         "brightness=%u, lv_mem peak=%u, tile cache=%uB\n",
+         (unsigned)millis(), (unsigned)frames,
+         (unsigned)(frames ? render_us / frames : 0), (unsigned)render_max_us,
+         (unsigned)brightness, (unsigned)mon.max_used,
+         (unsigned)tile_cache_bytes());
+  printf("[sim] bus %llu bytes, %u per frame, vscroll=%d shifts=%u\n",
+         (unsigned long long)bus_bytes,
+         (unsigned)(frames ? bus_bytes / frames : 0), DISP_VSCROLL,
+#if DISP_VSCROLL
+         (unsigned)disp_vscroll_shifts());
+#else
+         0u);
+#endif
+#ifdef PERF_TRACE
+  perf_trace_dump();
+#endif
+#ifdef LATENCY_TRACE
+  latency_trace_dump();
+#endif
+  if (!script.touches.empty())
+    printf("[sim] flicks=%u\n", (unsigned)gesture_flicks());
+  return 0;
+}
+#endif
@@ -0,0 +1,95 @@
+#include "sim_script.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+bool sim_script_load(const char *path, sim_script_t *out) {
+  FILE *f = fopen(path, "r");
+  if (f == NULL)
+    return false;
+
+  std::vector<sim_touch_t> &script = out->touches;
+  sim_touch_t touch = {0, false, 0, 0, 0};
+  char line[128];
+  while (fgets(line, sizeof(line), f)) {
+    char *hash = strchr(line, '#');
+    if (hash)
+      *hash = '\0';
+
+    unsigned t, dur, gesture = 0;
+    int x0, y0, x1, y1;
+    char cmd[8];
+    if (sscanf(line, "%u %7s", &t, cmd) != 2)
+      continue;
+
+    if (strcmp(cmd, "up") == 0) {
+      sscanf(line, "%*u %*s %x", &gesture);
+      script.push_back({t, false, touch.x, touch.y, (uint8_t)gesture});
+    } else if ((strcmp(cmd, "down") == 0 || strcmp(cmd, "move") == 0) &&
+               sscanf(line, "%*u %*s %d %d", &x0, &y0) == 2) {
+      script.push_back({t, true, (lv_coord_t)x0, (lv_coord_t)y0, 0});
+    } else if (strcmp(cmd, "swipe") == 0 &&
+               sscanf(line, "%*u %*s %d %d %d %d %u %x", &x0, &y0, &x1, &y1,
+                      &dur, &gesture) >= 5) {
+      for (uint32_t dt = 0; dt <= dur; dt += SIM_SWIPE_STEP_MS) {
+        lv_coord_t x = x0 + (int32_t)(x1 - x0) * (int32_t)dt / (int32_t)dur;
+        lv_coord_t y = y0 + (int32_t)(y1 - y0) * (int32_t)dt / (int32_t)dur;
+        script.push_back({t + dt, true, x, y, 0});
+      }
+      script.push_back({t + dur + SIM_SWIPE_STEP_MS, false, (lv_coord_t)x1,
+                        (lv_coord_t)y1, (uint8_t)gesture});
+    } else if (strcmp(cmd, "expect") == 0 &&
+               sscanf(line, "%*u %*s %d %d", &x0, &y0) == 2) {
+      out->expects.push_back({t, (uint8_t)x0, (uint8_t)y0});
+      continue;
+    } else {
+      fprintf(stderr, "sim: bad script line: %s", line);
+      continue;
+    }
+    touch = script.back(); // "up" keeps the last position
+  }
+  fclose(f);
+
+  std::stable_sort(script.begin(), script.end(),
+                   [](const sim_touch_t &a, const sim_touch_t &b) {
+                     return a.t_ms < b.t_ms;
+                   });
+  std::stable_sort(out->expects.begin(), out->expects.end(),
+                   [](const sim_expect_t &a, const sim_expect_t &b) {
+                     return a.t_ms < b.t_ms;
+                   });
+  return true;
+}
+
+touch_sample_t sim_script_sample(const sim_touch_t *t, int dx, int dy) {
+  int x = t->x + dx, y = t->y + dy;
+  touch_sample_t s = {(uint16_t)LV_MAX(x, 0),
+                      (uint16_t)LV_MAX(y, 0),
+                      t->gesture,
+                      (uint8_t)t->pressed,
+                      t->pressed ? (uint8_t)TOUCH_EVENT_CONTACT
+                                 : (uint8_t)TOUCH_EVENT_UP,
+                      t->t_ms};
+  return s;
+}
+
+void sim_script_at(const sim_script_t *s, uint32_t t, float *x, float *y,
+                   float *vx, float *vy) {
+  const std::vector<sim_touch_t> &script = s->touches;
+  auto it = std::upper_bound(
+      script.begin(), script.end(), t,
+      [](uint32_t t, const sim_touch_t &e) { return t < e.t_ms; });
+  const sim_touch_t &a = it == script.begin() ? *it : *(it - 1);
+  *x = a.x;
+  *y = a.y;
+  *vx = *vy = 0;
+  if (it == script.begin() || it == script.end() || !a.pressed)
+    return;
+
+  const sim_touch_t &b = *it;
+  float f = (float)(t - a.t_ms) / (b.t_ms - a.t_ms);
+  *x += (b.x - a.x) * f;
+  *y += (b.y - a.y) * f;
+  *vx = (float)(b.x - a.x) / (b.t_ms - a.t_ms);
+  *vy = (float)(b.y - a.y) / (b.t_ms - a.t_ms);
+}
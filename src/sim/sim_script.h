@@ -0,0 +1,47 @@
+#ifndef SIM_SCRIPT_H
+#define SIM_SCRIPT_H
+
+#include "touch_input.h"
+#include <lvgl.h>
+#include <stdint.h>
+#include <vector>
+
+// Recorded touch traces for the simulator and the host tests.
+// One event per line ('#' starts a comment):
+//   <t_ms> down <x> <y>
+//   <t_ms> move <x> <y>
+//   <t_ms> up [gesture]
+//   <t_ms> swipe <x0> <y0> <x1> <y1> <dur_ms> [gesture]
+//   <t_ms> expect <col> <row>
+// `gesture` is the CST816S GestureID the release reports (hex). `expect`
+// is the tile that should be shown at that time (test/test_gestures).
+
+#define SIM_SWIPE_STEP_MS 10 // CST816S report period while a finger is down
+
+typedef struct {
+  uint32_t t_ms;
+  bool pressed;
+  lv_coord_t x, y;
+  uint8_t gesture;
+} sim_touch_t;
+
+typedef struct {
+  uint32_t t_ms;
+  uint8_t col, row;
+} sim_expect_t;
+
+typedef struct {
+  std::vector<sim_touch_t> touches; // by time
+  std::vector<sim_expect_t> expects; // by time
+} sim_script_t;
+
+bool sim_script_load(const char *path, sim_script_t *out);
+
+// The controller's report for `t`, moved by (dx, dy) of noise
+touch_sample_t sim_script_sample(const sim_touch_t *t, int dx, int dy);
+
+// Finger position and velocity (px/ms) the script describes at `t`
+void sim_script_at(const sim_script_t *s, uint32_t t, float *x, float *y,
+                   float *vx, float *vy);
+
+#endif
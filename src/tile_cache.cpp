@@ -0,0 +1,213 @@
+#include "tile_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Image layout, in uint16_t units: one offset per row, then every row as
+// (run length, colour) pairs covering the full tile width. Colours are
+// stored as lv_color_t.full, i.e. already in wire byte order.
+
+typedef struct {
+  lv_obj_t *tile;
+  uint16_t *img; // NULL: not taken yet
+  uint32_t bytes;
+  lv_coord_t w, h;
+  bool failed; // did not fit TILE_CACHE_MAX_BYTES, wait for invalidate
+  bool active; // drawn from the image right now
+  lv_opa_t bg_opa;
+  uint32_t hidden; // children hidden by begin(), bit per child index
+} tile_cache_slot_t;
+
+static tile_cache_slot_t slots[TILE_CACHE_SLOTS];
+
+static tile_cache_slot_t *slot_of(const lv_obj_t *tile) {
+  for (int i = 0; i < TILE_CACHE_SLOTS; i++)
+    if (slots[i].tile == tile)
+      return &slots[i];
+  return NULL;
+}
+
+// Renders the tile band by band through a private draw context, the way
+// lv_snapshot does, but without a full-size buffer.
+static bool snapshot(tile_cache_slot_t *s) {
+  lv_obj_update_layout(s->tile);
+  const lv_area_t *c = &s->tile->coords;
+  lv_coord_t w = lv_area_get_width(c);
+  lv_coord_t h = lv_area_get_height(c);
+  uint32_t cap = TILE_CACHE_MAX_BYTES / sizeof(uint16_t);
+
+  lv_disp_t *disp = lv_obj_get_disp(s->tile);
+  uint16_t *img = (uint16_t *)malloc(cap * sizeof(uint16_t));
+  lv_color_t *band =
+      (lv_color_t *)malloc(w * TILE_CACHE_BAND_ROWS * sizeof(lv_color_t));
+  lv_draw_ctx_t *ctx = (lv_draw_ctx_t *)lv_mem_alloc(
+      disp->driver->draw_ctx_size);
+  bool ok = img && band && ctx && (uint32_t)h < cap;
+
+  lv_disp_drv_t drv;
+  lv_disp_t fake;
+  lv_disp_t *refreshing = _lv_refr_get_disp_refreshing();
+  bool drawing = ok;
+  if (drawing) {
+    lv_disp_drv_init(&drv);
+    drv.hor_res = lv_disp_get_hor_res(disp);
+    drv.ver_res = lv_disp_get_ver_res(disp);
+    lv_memset_00(&fake, sizeof(fake));
+    fake.driver = &drv;
+    disp->driver->draw_ctx_init(&drv, ctx);
+    drv.draw_ctx = ctx;
+    _lv_refr_set_disp_refreshing(&fake);
+  }
+
+  uint32_t n = h; // row offsets come first
+  for (lv_coord_t y0 = 0; ok && y0 < h; y0 += TILE_CACHE_BAND_ROWS) {
+    lv_area_t area = {c->x1, (lv_coord_t)(c->y1 + y0), c->x2,
+                      (lv_coord_t)LV_MIN(c->y1 + y0 + TILE_CACHE_BAND_ROWS - 1,
+                                         c->y2)};
+    memset(band, 0, w * TILE_CACHE_BAND_ROWS * sizeof(lv_color_t));
+    ctx->buf = band;
+    ctx->buf_area = &area;
+    ctx->clip_area = &area;
+    lv_obj_redraw(ctx, s->tile);
+
+    for (lv_coord_t r = 0; ok && r < lv_area_get_height(&area); r++) {
+      const lv_color_t *px = band + r * w;
+      img[y0 + r] = n;
+      for (lv_coord_t x = 0; x < w;) {
+        uint16_t len = 1;
+        while (x + len < w && px[x + len].full == px[x].full)
+          len++;
+        if (n + 2 > cap) {
+          ok = false;
+          break;
+        }
+        img[n++] = len;
+        img[n++] = px[x].full;
+        x += len;
+      }
+    }
+  }
+
+  if (drawing) {
+    _lv_refr_set_disp_refreshing(refreshing);
+    disp->driver->draw_ctx_deinit(&drv, ctx);
+  }
+  if (ctx)
+    lv_mem_free(ctx);
+  free(band);
+
+  if (!ok) {
+    free(img);
+    return false;
+  }
+  s->img = (uint16_t *)realloc(img, n * sizeof(uint16_t));
+  s->bytes = n * sizeof(uint16_t);
+  s->w = w;
+  s->h = h;
+  return true;
+}
+
+static void tile_draw_cb(lv_event_t *e) {
+  tile_cache_slot_t *s = (tile_cache_slot_t *)lv_event_get_user_data(e);
+  if (!s->active || s->img == NULL)
+    return;
+
+  lv_draw_ctx_t *ctx = lv_event_get_draw_ctx(e);
+  const lv_area_t *c = &s->tile->coords;
+  lv_area_t clip;
+  if (lv_area_get_width(c) != s->w || lv_area_get_height(c) != s->h ||
+      !_lv_area_intersect(&clip, c, ctx->clip_area))
+    return;
+
+  lv_color_t *buf = (lv_color_t *)ctx->buf;
+  int32_t buf_w = lv_area_get_width(ctx->buf_area);
+  int32_t sx0 = clip.x1 - c->x1;
+  int32_t sx1 = clip.x2 - c->x1;
+
+  for (lv_coord_t y = clip.y1; y <= clip.y2; y++) {
+    const uint16_t *run = s->img + s->img[y - c->y1];
+    lv_color_t *dst = buf + (y - ctx->buf_area->y1) * buf_w +
+                      (clip.x1 - ctx->buf_area->x1);
+
+    int32_t x = 0; // first column of `run`
+    while (x + run[0] <= sx0) {
+      x += run[0];
+      run += 2;
+    }
+    for (int32_t sx = sx0; sx <= sx1; x += run[0], run += 2) {
+      int32_t end = LV_MIN(x + run[0] - 1, sx1);
+      lv_color_t col;
+      col.full = run[1];
+      for (; sx <= end; sx++)
+        *dst++ = col;
+    }
+  }
+}
+
+void tile_cache_enable(lv_obj_t *tile) {
+  if (slot_of(tile))
+    return;
+  tile_cache_slot_t *s = slot_of(NULL);
+  if (s == NULL)
+    return;
+  memset(s, 0, sizeof(*s));
+  s->tile = tile;
+  lv_obj_add_event_cb(tile, tile_draw_cb, LV_EVENT_DRAW_MAIN, s);
+}
+
+void tile_cache_invalidate(lv_obj_t *tile) {
+  tile_cache_slot_t *s = slot_of(tile);
+  if (s == NULL)
+    return;
+  free(s->img);
+  s->img = NULL;
+  s->bytes = 0;
+  s->failed = false;
+}
+
+void tile_cache_begin(void) {
+  for (int i = 0; i < TILE_CACHE_SLOTS; i++) {
+    tile_cache_slot_t *s = &slots[i];
+    if (s->tile == NULL || s->active || lv_obj_get_child_cnt(s->tile) == 0)
+      continue; // free slot, or tile content not built
+    if (s->img == NULL && !s->failed)
+      s->failed = !snapshot(s);
+    if (s->img == NULL)
+      continue;
+
+    s->hidden = 0;
+    uint32_t cnt = LV_MIN(lv_obj_get_child_cnt(s->tile), 32u);
+    for (uint32_t k = 0; k < cnt; k++) {
+      lv_obj_t *child = lv_obj_get_child(s->tile, k);
+      if (!lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) {
+        lv_obj_add_flag(child, LV_OBJ_FLAG_HIDDEN);
+        s->hidden |= 1u << k;
+      }
+    }
+    s->bg_opa = lv_obj_get_style_bg_opa(s->tile, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(s->tile, LV_OPA_TRANSP, 0); // image covers it
+    s->active = true;
+  }
+}
+
+void tile_cache_end(void) {
+  for (int i = 0; i < TILE_CACHE_SLOTS; i++) {
+    tile_cache_slot_t *s = &slots[i];
+    if (!s->active)
+      continue;
+
+    // Children may have been deleted meanwhile (tile teardown)
+    uint32_t cnt = LV_MIN(lv_obj_get_child_cnt(s->tile), 32u);
+    for (uint32_t k = 0; k < cnt; k++)
+      if (s->hidden & (1u << k))
+        lv_obj_clear_flag(lv_obj_get_child(s->tile, k), LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_style_bg_opa(s->tile, s->bg_opa, 0);
+    s->active = false;
+  }
+}
+
+uint32_t tile_cache_bytes(void) {
+  uint32_t sum = 0;
+  for (int i = 0; i < TILE_CACHE_SLOTS; i++)
+    sum += slots[i].bytes;
+  return sum;
+}
@@ -0,0 +1,224 @@
+#include "timekeeping.h"
+#include "idle_sched.h"
+#include <Arduino.h>
+#include <ctype.h>
+#include <stdlib.h>
+
+// The RTC counts 8 Hz ticks in 24 bits; overflows are counted in software
+// to give a 64-bit tick count that never wraps in practice. Wall time is
+// base_epoch plus the ticks elapsed since base_ticks.
+
+static uint64_t base_ticks = 0;
+static uint32_t base_epoch = 0;
+static int32_t zone_offset_s = 0;
+static tk_dst_rule_t dst_rule = TK_DST_NONE;
+static volatile bool alarm_pending = false;
+
+#if defined(NRF52840_XXAA)
+// RTC0 belongs to the SoftDevice and RTC1 to the FreeRTOS tick
+#define TK_RTC NRF_RTC2
+#define TK_RTC_IRQn RTC2_IRQn
+#define TK_RTC_IRQHandler RTC2_IRQHandler
+
+static volatile uint32_t overflows = 0;
+
+extern "C" void TK_RTC_IRQHandler(void) {
+  if (TK_RTC->EVENTS_OVRFLW) {
+    TK_RTC->EVENTS_OVRFLW = 0;
+    overflows++;
+  }
+  if (TK_RTC->EVENTS_COMPARE[0]) {
+    TK_RTC->EVENTS_COMPARE[0] = 0;
+    TK_RTC->EVTENCLR = RTC_EVTEN_COMPARE0_Msk;
+    TK_RTC->INTENCLR = RTC_INTENCLR_COMPARE0_Msk;
+    alarm_pending = true;
+    idle_sched_wake_from_isr();
+  }
+  (void)TK_RTC->EVENTS_OVRFLW;
+}
+
+static void rtc_start(void) {
+  TK_RTC->TASKS_STOP = 1;
+  TK_RTC->TASKS_CLEAR = 1;
+  TK_RTC->PRESCALER = 32768 / TK_RTC_HZ - 1;
+  TK_RTC->EVTENSET = RTC_EVTEN_OVRFLW_Msk;
+  TK_RTC->INTENSET = RTC_INTENSET_OVRFLW_Msk;
+  NVIC_ClearPendingIRQ(TK_RTC_IRQn);
+  NVIC_SetPriority(TK_RTC_IRQn, 6);
+  NVIC_EnableIRQ(TK_RTC_IRQn);
+  TK_RTC->TASKS_START = 1;
+}
+
+static uint64_t rtc_ticks(void) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  uint32_t ovf = overflows;
+  uint32_t cnt = TK_RTC->COUNTER;
+  if (TK_RTC->EVENTS_OVRFLW) { // wrapped, ISR not run yet
+    ovf++;
+    cnt = TK_RTC->COUNTER;
+  }
+  __set_PRIMASK(primask);
+  return ((uint64_t)ovf << 24) | cnt;
+}
+
+static void rtc_arm(uint64_t at) {
+  TK_RTC->INTENCLR = RTC_INTENCLR_COMPARE0_Msk;
+  TK_RTC->EVENTS_COMPARE[0] = 0;
+  TK_RTC->CC[0] = (uint32_t)at & RTC_COUNTER_COUNTER_Msk;
+  TK_RTC->EVTENSET = RTC_EVTEN_COMPARE0_Msk;
+  TK_RTC->INTENSET = RTC_INTENSET_COMPARE0_Msk;
+  // A compare value less than 2 ticks ahead may be missed by the RTC
+  if (at <= rtc_ticks() + 1) {
+    TK_RTC->INTENCLR = RTC_INTENCLR_COMPARE0_Msk;
+    alarm_pending = true;
+  }
+}
+#else
+// Host fake RTC: a 24-bit COUNTER and a software overflow count, put
+// together as on the device
+#define TK_FAKE_COUNTER_MASK 0xFFFFFFu
+
+static uint64_t fake_ms = 0;
+static uint32_t fake_counter = 0;
+static uint32_t overflows = 0;
+static uint64_t fake_alarm = UINT64_MAX;
+
+static void rtc_start(void) {}
+
+static uint64_t rtc_ticks(void) {
+  return ((uint64_t)overflows << 24) | fake_counter;
+}
+
+static void rtc_arm(uint64_t at) {
+  fake_alarm = at;
+  if (at <= rtc_ticks())
+    alarm_pending = true;
+}
+
+void timekeeping_fake_advance_ms(uint32_t ms) {
+  uint64_t before = fake_ms * TK_RTC_HZ / 1000;
+  fake_ms += ms;
+  uint64_t ticks = fake_ms * TK_RTC_HZ / 1000;
+  overflows += (uint32_t)((ticks >> 24) - (before >> 24)); // OVRFLW events
+  fake_counter = (uint32_t)ticks & TK_FAKE_COUNTER_MASK;
+  if (rtc_ticks() >= fake_alarm) {
+    fake_alarm = UINT64_MAX;
+    alarm_pending = true;
+  }
+}
+#endif
+
+void timekeeping_init(uint32_t epoch) {
+  rtc_start();
+  timekeeping_set(epoch);
+}
+
+uint32_t timekeeping_now(uint16_t *ms) {
+  uint64_t elapsed = rtc_ticks() - base_ticks;
+  if (ms)
+    *ms = (uint16_t)((elapsed % TK_RTC_HZ) * 1000 / TK_RTC_HZ);
+  return base_epoch + (uint32_t)(elapsed / TK_RTC_HZ);
+}
+
+void timekeeping_set(uint32_t epoch) {
+  base_ticks = rtc_ticks();
+  base_epoch = epoch;
+}
+
+void timekeeping_set_zone(int16_t offset_min, tk_dst_rule_t rule) {
+  zone_offset_s = offset_min * 60;
+  dst_rule = rule;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+static int32_t days_from_civil(int32_t y, uint32_t m, uint32_t d) {
+  y -= m <= 2;
+  int32_t era = (y >= 0 ? y : y - 399) / 400;
+  uint32_t yoe = (uint32_t)(y - era * 400);
+  uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int32_t)doe - 719468;
+}
+
+// Year of a local time, which may lie before 1970 or after 2106
+static int32_t year_of(int64_t t) {
+  int32_t z = (int32_t)((t >= 0 ? t : t - 86399) / 86400) + 719468;
+  int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+  uint32_t doe = z - era * 146097;
+  uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  uint32_t mp = (5 * doy + 2) / 153;
+  return (int32_t)yoe + era * 400 + (mp >= 10);
+}
+
+// 0 = Sunday
+static uint32_t weekday(int32_t days) { return (uint32_t)(days + 4) % 7; }
+
+// Day number of the n-th (1-based) Sunday of a month; n = 0 for the last
+static int32_t nth_sunday(int32_t y, uint32_t m, uint32_t n) {
+  if (n == 0) {
+    int32_t last = days_from_civil(y, m + 1, 1) - 1; // m < 12 here
+    return last - weekday(last);
+  }
+  int32_t first = days_from_civil(y, m, 1);
+  return first + (7 - weekday(first)) % 7 + 7 * (n - 1);
+}
+
+int32_t timekeeping_local_offset(uint32_t epoch) {
+  if (dst_rule == TK_DST_NONE)
+    return zone_offset_s;
+
+  int32_t y = year_of((int64_t)epoch + zone_offset_s);
+  int64_t start, end; // UTC seconds
+  if (dst_rule == TK_DST_EU) {
+    start = (int64_t)nth_sunday(y, 3, 0) * 86400 + 3600;
+    end = (int64_t)nth_sunday(y, 10, 0) * 86400 + 3600;
+  } else {
+    start = (int64_t)nth_sunday(y, 3, 2) * 86400 + 7200 - zone_offset_s;
+    end = (int64_t)nth_sunday(y, 11, 1) * 86400 + 7200 - zone_offset_s - 3600;
+  }
+
+  bool dst = (int64_t)epoch >= start && (int64_t)epoch < end;
+  return zone_offset_s + (dst ? 3600 : 0);
+}
+
+uint32_t timekeeping_local(uint16_t *ms) {
+  uint32_t now = timekeeping_now(ms);
+  return now + timekeeping_local_offset(now);
+}
+
+void timekeeping_arm(uint32_t epoch) {
+  alarm_pending = false;
+  rtc_arm(base_ticks + (uint64_t)(epoch - base_epoch) * TK_RTC_HZ);
+}
+
+bool timekeeping_take_alarm(void) {
+  if (!alarm_pending)
+    return false;
+  alarm_pending = false;
+  return true;
+}
+
+bool timekeeping_command(const char *line) {
+  if (line[0] == 'T' && isdigit((unsigned char)line[1])) {
+    timekeeping_set(strtoul(line + 1, NULL, 10));
+    Serial.printf("time set: %lu\n", timekeeping_now(NULL));
+    return true;
+  }
+  if (line[0] == 'Z') {
+    char *rest;
+    long offset = strtol(line + 1, &rest, 10);
+    long rule = TK_DST_NONE;
+    if (*rest == ',')
+      rule = strtol(rest + 1, NULL, 10);
+    if (rule < TK_DST_NONE || rule > TK_DST_US) {
+      Serial.printf("zone: unknown dst rule %ld\n", rule);
+      return true;
+    }
+    timekeeping_set_zone((int16_t)offset, (tk_dst_rule_t)rule);
+    Serial.printf("zone set: %ld min, dst rule %ld\n", offset, rule);
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,135 @@
+#include "touch_bus.h"
+
+#ifdef TOUCH_BUS_DMA
+#include <Arduino.h>
+
+// The transfer is TX (register) + RX (burst) with LASTTX_STARTRX and
+// LASTRX_STOP shorts, so a STARTTX from PPI runs it to EVENTS_STOPPED
+// without the CPU. No TWIM interrupt is used: touch_bus_take() is called
+// from the main loop after the pin interrupt woke it up. A new edge while
+// the bytes are copied would overwrite them, but the controller reports at
+// most every 10 ms.
+
+#define BUS NRF_TWIM0
+#define STOP_TIMEOUT_US 100 // a byte and the stop condition take ~25 us
+
+static uint8_t tx_reg;
+static uint8_t rx_buf[TOUCH_BUS_MAX_LEN];
+static uint8_t rx_len;
+static int ppi_ch = -1;
+
+static void od_pin(uint32_t pin) {
+  NRF_GPIO_Type *port = pin < 32 ? NRF_P0 : NRF_P1;
+  port->PIN_CNF[pin & 31] =
+      (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos) |
+      (GPIO_PIN_CNF_INPUT_Connect << GPIO_PIN_CNF_INPUT_Pos) |
+      (GPIO_PIN_CNF_PULL_Pullup << GPIO_PIN_CNF_PULL_Pos) |
+      (GPIO_PIN_CNF_DRIVE_S0D1 << GPIO_PIN_CNF_DRIVE_Pos);
+}
+
+void touch_bus_init(uint8_t sda, uint8_t scl) {
+  BUS->ENABLE = TWIM_ENABLE_ENABLE_Disabled << TWIM_ENABLE_ENABLE_Pos;
+
+  od_pin(g_ADigitalPinMap[sda]);
+  od_pin(g_ADigitalPinMap[scl]);
+  BUS->PSEL.SDA = g_ADigitalPinMap[sda];
+  BUS->PSEL.SCL = g_ADigitalPinMap[scl];
+  BUS->FREQUENCY = TWIM_FREQUENCY_FREQUENCY_K400;
+  BUS->INTENCLR = 0xFFFFFFFF;
+  BUS->SHORTS = TWIM_SHORTS_LASTTX_STARTRX_Msk | TWIM_SHORTS_LASTRX_STOP_Msk;
+  BUS->TXD.LIST = 0;
+  BUS->RXD.LIST = 0;
+
+  BUS->ENABLE = TWIM_ENABLE_ENABLE_Enabled << TWIM_ENABLE_ENABLE_Pos;
+}
+
+// GPIOTE channel the core's attachInterrupt() gave to `pin`
+static int gpiote_channel(uint8_t pin) {
+  uint32_t psel = g_ADigitalPinMap[pin];
+  for (int ch = 0; ch < 8; ch++) {
+    uint32_t cfg = NRF_GPIOTE->CONFIG[ch];
+    bool event = ((cfg & GPIOTE_CONFIG_MODE_Msk) >> GPIOTE_CONFIG_MODE_Pos) ==
+                 GPIOTE_CONFIG_MODE_Event;
+    // PSEL and PORT are adjacent: together they hold the 0..47 pin number
+    if (event && ((cfg >> GPIOTE_CONFIG_PSEL_Pos) & 0x3F) == psel)
+      return ch;
+  }
+  return -1;
+}
+
+// A programmable PPI channel that is off and has no endpoints set
+static int free_ppi_channel(void) {
+  for (int ch = TOUCH_BUS_PPI_CHANNELS - 1; ch >= 0; ch--)
+    if (!(NRF_PPI->CHEN & (1u << ch)) && NRF_PPI->CH[ch].EEP == 0 &&
+        NRF_PPI->CH[ch].TEP == 0)
+      return ch;
+  return -1;
+}
+
+bool touch_bus_arm(uint8_t int_pin, uint8_t addr, uint8_t reg, uint8_t len) {
+  int ch = gpiote_channel(int_pin);
+  if (ch < 0 || len > TOUCH_BUS_MAX_LEN)
+    return false;
+  if (ppi_ch < 0)
+    ppi_ch = free_ppi_channel();
+  if (ppi_ch < 0)
+    return false;
+
+  tx_reg = reg;
+  rx_len = len;
+  BUS->ADDRESS = addr;
+  BUS->TXD.PTR = (uint32_t)&tx_reg;
+  BUS->TXD.MAXCNT = 1;
+  BUS->RXD.PTR = (uint32_t)rx_buf;
+  BUS->RXD.MAXCNT = len;
+  BUS->EVENTS_STOPPED = 0;
+  BUS->EVENTS_ERROR = 0;
+
+  NRF_PPI->CH[ppi_ch].EEP = (uint32_t)&NRF_GPIOTE->EVENTS_IN[ch];
+  NRF_PPI->CH[ppi_ch].TEP = (uint32_t)&BUS->TASKS_STARTTX;
+  NRF_PPI->CHENSET = 1u << ppi_ch;
+  return true;
+}
+
+// End the transfer and clear its events. A bus the controller holds low
+// never gets to STOPPED; the peripheral is reset then (registers are kept).
+static void stop(void) {
+  BUS->TASKS_STOP = 1;
+  uint32_t t0 = micros();
+  while (!BUS->EVENTS_STOPPED) {
+    if (micros() - t0 > STOP_TIMEOUT_US) {
+      BUS->ENABLE = TWIM_ENABLE_ENABLE_Disabled << TWIM_ENABLE_ENABLE_Pos;
+      BUS->ENABLE = TWIM_ENABLE_ENABLE_Enabled << TWIM_ENABLE_ENABLE_Pos;
+      break;
+    }
+  }
+  BUS->EVENTS_STOPPED = 0;
+  BUS->EVENTS_ERROR = 0;
+  BUS->ERRORSRC = BUS->ERRORSRC; // write 1 to clear
+}
+
+int touch_bus_take(uint8_t *out) {
+  if (BUS->EVENTS_ERROR) {
+    stop(); // a NACK does not end the transfer by itself
+    return -1;
+  }
+  if (!BUS->EVENTS_STOPPED)
+    return 0;
+
+  BUS->EVENTS_STOPPED = 0;
+  memcpy(out, rx_buf, rx_len);
+  return 1;
+}
+
+void touch_bus_abort(void) { stop(); }
+
+void touch_bus_end(void) {
+  if (ppi_ch >= 0) {
+    NRF_PPI->CHENCLR = 1u << ppi_ch;
+    NRF_PPI->CH[ppi_ch].EEP = 0;
+    NRF_PPI->CH[ppi_ch].TEP = 0;
+    ppi_ch = -1;
+  }
+  BUS->ENABLE = TWIM_ENABLE_ENABLE_Disabled << TWIM_ENABLE_ENABLE_Pos;
+}
+#endif
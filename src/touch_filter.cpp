@@ -0,0 +1,112 @@
+#include "touch_filter.h"
+#include <math.h>
+
+typedef struct {
+  lv_obj_t *scr;
+  touch_filter_cfg_t cfg;
+} screen_cfg_t;
+
+static const touch_filter_cfg_t default_cfg = TOUCH_FILTER_CFG_DEFAULT;
+static screen_cfg_t screens[TOUCH_FILTER_SCREENS];
+
+void touch_filter_set_config(lv_obj_t *scr, const touch_filter_cfg_t *cfg) {
+  screen_cfg_t *free_slot = NULL;
+  for (int i = 0; i < TOUCH_FILTER_SCREENS; i++) {
+    if (screens[i].scr == scr) {
+      free_slot = &screens[i];
+      break;
+    }
+    if (screens[i].scr == NULL && free_slot == NULL)
+      free_slot = &screens[i];
+  }
+  if (free_slot == NULL)
+    return;
+
+  free_slot->scr = cfg ? scr : NULL;
+  if (cfg)
+    free_slot->cfg = *cfg;
+}
+
+const touch_filter_cfg_t *touch_filter_config(void) {
+  lv_obj_t *scr = lv_scr_act();
+  for (int i = 0; i < TOUCH_FILTER_SCREENS; i++)
+    if (screens[i].scr != NULL && screens[i].scr == scr)
+      return &screens[i].cfg;
+  return &default_cfg;
+}
+
+void touch_filter_reset(touch_filter_t *f) { f->primed = false; }
+
+// Smoothing factor of a first-order low-pass at `cutoff_hz` for a step of
+// `dt_ms`; its delay on a ramp is tau
+static float alpha(float cutoff_hz, float dt_ms, float *tau_ms) {
+  float tau = 1000.0f / (2.0f * (float)M_PI * cutoff_hz);
+  if (tau_ms)
+    *tau_ms = tau;
+  return 1.0f / (1.0f + tau / dt_ms);
+}
+
+void touch_filter_update(touch_filter_t *f, const touch_filter_cfg_t *cfg,
+                         lv_coord_t x, lv_coord_t y, uint32_t t_ms) {
+  if (!f->primed) {
+    f->x = x;
+    f->y = y;
+    f->dx = f->dy = 0;
+    f->lag_ms = 0;
+    f->t_ms = t_ms;
+    f->primed = true;
+    return;
+  }
+
+  float dt = (float)(t_ms - f->t_ms);
+  if (dt <= 0)
+    dt = 1; // two reports in the same millisecond
+  f->t_ms = t_ms;
+
+  float ad = alpha(cfg->d_cutoff_hz, dt, NULL);
+  f->dx += ad * ((x - f->x) / dt - f->dx);
+  f->dy += ad * ((y - f->y) / dt - f->dy);
+
+  float speed = sqrtf(f->dx * f->dx + f->dy * f->dy) * 1000.0f; // px/s
+  float a = alpha(cfg->min_cutoff_hz + cfg->beta * speed, dt, &f->lag_ms);
+  f->x += a * (x - f->x);
+  f->y += a * (y - f->y);
+}
+
+lv_point_t touch_filter_predict(const touch_filter_t *f,
+                                const touch_filter_cfg_t *cfg,
+                                uint32_t ahead_ms) {
+  float ahead = 0;
+  if (cfg->predict_max_ms) {
+    ahead = f->lag_ms + ahead_ms;
+    if (ahead > cfg->predict_max_ms)
+      ahead = cfg->predict_max_ms;
+  }
+  lv_point_t p = {(lv_coord_t)lroundf(f->x + f->dx * ahead),
+                  (lv_coord_t)lroundf(f->y + f->dy * ahead)};
+  return p;
+}
+
+uint32_t touch_filter_ahead_ms(uint32_t age_ms) {
+  uint32_t until = 0;
+  lv_disp_t *disp = lv_disp_get_default();
+  if (disp != NULL && disp->refr_timer != NULL) {
+    // A paused timer still runs as soon as it is resumed past its period
+    uint32_t elapsed = lv_tick_elaps(disp->refr_timer->last_run);
+    if (elapsed < disp->refr_timer->period)
+      until = disp->refr_timer->period - elapsed;
+  }
+  return age_ms + until + TOUCH_FILTER_LEAD_MS;
+}
+
+void touch_filter_apply(touch_filter_t *f, lv_point_t *p, bool pressed,
+                        uint32_t t_ms, uint32_t now_ms) {
+  if (!pressed) {
+    touch_filter_reset(f);
+    return;
+  }
+  const touch_filter_cfg_t *cfg = touch_filter_config();
+  touch_filter_update(f, cfg, p->x, p->y, t_ms);
+  f->ahead_ms = touch_filter_ahead_ms(now_ms - t_ms);
+  *p = touch_filter_predict(f, cfg, f->ahead_ms);
+}
@@ -0,0 +1,48 @@
+#include "touch_indev.h"
+#include "gesture.h"
+#include "latency_trace.h"
+#include "touch_filter.h"
+#include "touch_input.h"
+#include <Arduino.h>
+
+static void (*press_cb)(void) = NULL;
+
+void touch_indev_init(void (*on_press)(void)) { press_cb = on_press; }
+
+void touch_indev_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+  static lv_indev_state_t state = LV_INDEV_STATE_REL;
+  static lv_point_t point = {0, 0};
+#if TOUCH_FILTER
+  static touch_filter_t filter;
+#endif
+
+  touch_sample_t s;
+  while (touch_input_pop(&s)) {
+    LAT_TRACE_READ();
+    if (s.fingers != 0 && s.event != TOUCH_EVENT_UP && press_cb != NULL)
+      press_cb(); // Activity detected
+    gesture_feed(&s);
+  }
+  gesture_poll(millis());
+
+  gesture_point_t p;
+  if (gesture_pop(&p)) {
+#if TOUCH_FILTER
+    touch_filter_apply(&filter, &p.point, p.pressed, p.t_ms, millis());
+#endif
+    point = p.point;
+    state = p.pressed ? LV_INDEV_STATE_PR  // 押されている状態
+                      : LV_INDEV_STATE_REL; // 離されている状態
+
+    // Let LVGL process every buffered point in this read cycle
+    data->continue_reading = gesture_pending();
+  }
+
+  data->point = point;
+  data->state = state;
+
+  // Released and nothing buffered or held: stop polling until the next INT
+  if (state == LV_INDEV_STATE_REL && !touch_input_available() &&
+      !gesture_pending())
+    lv_timer_pause(drv->read_timer);
+}
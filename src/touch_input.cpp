@@ -0,0 +1,132 @@
+#include "touch_input.h"
+#include "FunctionalInterrupt.h"
+#include "idle_sched.h"
+#include "latency_trace.h"
+#include "spsc_ring.h"
+#include "touch_bus.h"
+#include <Arduino.h>
+#include <Wire.h>
+
+// Interrupt-driven CST816S input.
+// The INT edge only marks data ready; the I2C read happens in
+// touch_input_service() on the main loop and lands in a SPSC ring that the
+// LVGL read_cb drains. With TOUCH_BUS_DMA the edge also starts the read in
+// hardware (touch_bus.h) and the main loop only collects it.
+
+#define CST816S_ADDR 0x15
+#define CST816S_REG_GESTURE 0x01 // GestureID, FingerNum, XposH/L, YposH/L
+#define CST816S_BURST_LEN 6
+
+// Give up on a burst that has not completed this long after its edge
+#define TOUCH_BUS_TIMEOUT_US 5000
+
+static SpscRing<touch_sample_t, 16> ring;
+static volatile bool irq_pending = false;
+static volatile uint32_t irq_us = 0;
+static uint32_t dropped = 0;
+static touch_bus_stats_t bus_stats;
+static bool bus_dma = false; // INT edges start the TWIM burst
+
+static void touch_isr(void *ctx) {
+  (void)ctx;
+  irq_us = micros();
+  irq_pending = true;
+  LAT_TRACE_IRQ();
+  idle_sched_wake_from_isr();
+}
+
+// 1: `raw` filled, 0: burst still on the bus, -1: failed
+static int read_raw(uint8_t *raw) {
+#ifdef TOUCH_BUS_DMA
+  if (bus_dma)
+    return touch_bus_take(raw);
+#endif
+  Wire.beginTransmission(CST816S_ADDR);
+  Wire.write(CST816S_REG_GESTURE);
+  if (Wire.endTransmission(false) != 0)
+    return -1;
+  if (Wire.requestFrom(CST816S_ADDR, CST816S_BURST_LEN) != CST816S_BURST_LEN)
+    return -1;
+  for (int i = 0; i < CST816S_BURST_LEN; i++)
+    raw[i] = Wire.read();
+  return 1;
+}
+
+static void parse_sample(const uint8_t *raw, touch_sample_t *s) {
+  s->gesture = raw[0];
+  s->fingers = raw[1];
+  s->event = raw[2] >> 6;
+  s->x = ((raw[2] & 0x0F) << 8) | raw[3];
+  s->y = ((raw[4] & 0x0F) << 8) | raw[5];
+  s->t_ms = millis();
+}
+
+void touch_input_init(uint8_t int_pin) {
+  pinMode(int_pin, INPUT_PULLUP);
+  // Replaces the handler the CST816S library installed on the same pin
+  fi_attach(int_pin, touch_isr, NULL, FALLING);
+#ifdef TOUCH_BUS_DMA
+  bus_dma = touch_bus_arm(int_pin, CST816S_ADDR, CST816S_REG_GESTURE,
+                         CST816S_BURST_LEN);
+  if (!bus_dma) {
+    touch_bus_end();
+    Wire.begin();
+    Serial.println("[touch] no GPIOTE/PPI channel for the burst, using Wire");
+  }
+#endif
+}
+
+void touch_input_service(void) {
+  if (!irq_pending)
+    return;
+  uint32_t edge = irq_us;
+  irq_pending = false;
+
+  uint8_t raw[CST816S_BURST_LEN];
+  uint32_t t0 = micros();
+  int r = read_raw(raw);
+  uint32_t t1 = micros();
+  if (r == 0) {
+    if (t1 - edge < TOUCH_BUS_TIMEOUT_US) {
+      irq_pending = true; // come back on the next loop pass
+      return;
+    }
+#ifdef TOUCH_BUS_DMA
+    touch_bus_abort(); // only the burst reports 0
+#endif
+    r = -1;
+  }
+  if (r < 0) {
+    bus_stats.errors++;
+    return;
+  }
+
+  uint32_t cpu = t1 - t0;
+  uint32_t ready = t1 - edge;
+  bus_stats.samples++;
+  bus_stats.cpu_us_sum += cpu;
+  bus_stats.ready_us_sum += ready;
+  if (cpu > bus_stats.cpu_us_max)
+    bus_stats.cpu_us_max = cpu;
+  if (ready > bus_stats.ready_us_max)
+    bus_stats.ready_us_max = ready;
+
+  touch_sample_t s;
+  parse_sample(raw, &s);
+  if (!ring.push(s))
+    dropped++;
+}
+
+bool touch_input_irq_pending(void) { return irq_pending; }
+
+bool touch_input_pop(touch_sample_t *out) { return ring.pop(*out); }
+
+bool touch_input_available(void) { return !ring.empty(); }
+
+uint32_t touch_input_dropped(void) { return dropped; }
+
+void touch_input_get_bus_stats(touch_bus_stats_t *out) {
+  *out = bus_stats;
+  out->dma = bus_dma;
+  bus_stats = {};
+}
@@ -2,6 +2,15 @@
 // SquareLine Studio version: SquareLine Studio 1.6.0
 // LVGL version: 8.3.11
 // Project name: SquareLine_Project
+//
+// Hand-edited, re-apply after every SquareLine export (the export
+// overwrites this file and ui_comp_*.c):
+// - ui_comp_get_child() reads the children array from the component root's
+//   user_data and falls back to the LV_EVENT_GET_COMP_CHILD event when it
+//   is NULL, so freshly exported components keep working, only slower.
+// - ui_*_create() stores that array in the root's user_data, so the
+//   root's user_data belongs to the component: neither the app nor
+//   ui_comp_*_create_hook() may set it.
 
 #include "ui.h"
 #include "ui_helpers.h"
@@ -14,7 +23,11 @@ uint32_t child_idx;
 lv_obj_t* child;
 } ui_comp_get_child_t;
 
+// One load instead of an event dispatch through every callback on the
+// object; components created without the array still answer the event.
 lv_obj_t * ui_comp_get_child(lv_obj_t *comp, uint32_t child_idx) {
+lv_obj_t ** c = lv_obj_get_user_data(comp);
+if (c) return c[child_idx];
 ui_comp_get_child_t info;
 info.child = NULL;
 info.child_idx = child_idx;
@@ -30,5 +43,7 @@ info->child = c[info->child_idx];
 
 void del_component_child_event_cb(lv_event_t* e) {
 lv_obj_t** c = lv_event_get_user_data(e);
+lv_obj_t * comp = lv_event_get_target(e);
+if (lv_obj_get_user_data(comp) == c) lv_obj_set_user_data(comp, NULL);
 lv_mem_free(c); 
 }
@@ -32,6 +32,7 @@ lv_obj_set_style_text_opa(cui_Button1, 255, LV_PART_MAIN| LV_STATE_DEFAULT);
 
 lv_obj_t ** children = lv_mem_alloc(sizeof(lv_obj_t *) * _UI_COMP_BUTTON1_NUM);
 children[UI_COMP_BUTTON1_BUTTON1] = cui_Button1;
+lv_obj_set_user_data(cui_Button1, children); // hand edit, see ui_comp.c
 lv_obj_add_event_cb(cui_Button1, get_component_child_event_cb, LV_EVENT_GET_COMP_CHILD, children);
 lv_obj_add_event_cb(cui_Button1, del_component_child_event_cb, LV_EVENT_DELETE, children);
 lv_obj_add_event_cb(cui_Button1, ui_event_comp_Button1_Button1, LV_EVENT_ALL, children);
@@ -5,6 +5,7 @@
 
 #include "ui.h"
 
+// The root's user_data holds the children array: leave it (see ui_comp.c)
 void ui_comp_Button1_create_hook( lv_obj_t * comp)
 {
 }
@@ -0,0 +1,100 @@
+// RGB565 byte order on the wire: known colours rendered by LVGL and sent
+// through disp_flush must reach the panel big-endian, as the ST7789 reads
+// them. The panel is a memory copy of what went over the bus.
+
+#include "disp_flush.h"
+#include <lvgl.h>
+#include <unity.h>
+
+#define HOR_RES 240
+#define VER_RES 280
+#define BUF_PIXELS (HOR_RES * VER_RES / 10) // DISP_BUF_TENTH
+
+static uint8_t panel[HOR_RES * VER_RES * 2];
+static lv_area_t window;
+static uint32_t window_pos; // bytes written into the current window
+
+static lv_disp_draw_buf_t draw_buf;
+static lv_color_t buf[BUF_PIXELS];
+
+// Copies each chunk into the address window like RAMWR and completes at once
+static void panel_start(const uint8_t *ptr, uint16_t len, bool first) {
+  static const uint8_t *src;
+  if (first) {
+    src = ptr;
+    window_pos = 0;
+  }
+
+  lv_coord_t w = lv_area_get_width(&window);
+  for (uint32_t i = 0; i < len; i += 2, window_pos += 2) {
+    uint32_t px = window_pos / 2;
+    uint32_t at = ((window.y1 + px / w) * HOR_RES + window.x1 + px % w) * 2;
+    panel[at] = src[i];
+    panel[at + 1] = src[i + 1];
+  }
+  src += len;
+  disp_flush_chunk_done();
+}
+
+static void panel_finish(void) {}
+
+static const disp_flush_backend_t panel_backend = {panel_start, panel_finish};
+
+static void panel_flush(lv_disp_drv_t *disp, const lv_area_t *area,
+                        lv_color_t *color_p) {
+  window = *area;
+  disp_flush_start(disp, (const uint8_t *)&color_p->full,
+                   lv_area_get_size(area) * 2);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// Fills the screen with `hex`; every pixel must arrive as `rgb565`, high
+// byte first
+static void check_fill(uint32_t hex, uint16_t rgb565) {
+  lv_obj_t *scr = lv_scr_act();
+  lv_obj_set_style_bg_color(scr, lv_color_hex(hex), 0);
+  lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+  lv_refr_now(NULL);
+
+  uint32_t bad = 0;
+  for (uint32_t i = 0; i < HOR_RES * VER_RES; i++)
+    bad += ((panel[i * 2] << 8) | panel[i * 2 + 1]) != rgb565;
+
+  char msg[64];
+  snprintf(msg, sizeof(msg), "%06X -> %02X %02X, want %04X", (unsigned)hex,
+           panel[0], panel[1], rgb565);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, bad, msg);
+}
+
+static void test_red(void) { check_fill(0xFF0000, 0xF800); }
+
+static void test_green(void) { check_fill(0x00FF00, 0x07E0); }
+
+static void test_blue(void) { check_fill(0x0000FF, 0x001F); }
+
+// Both bytes differ and neither is symmetric under a swap
+static void test_mixed(void) { check_fill(0x123456, 0x11AA); }
+
+int main(int argc, char **argv) {
+  lv_init();
+  disp_flush_init(&panel_backend);
+  lv_disp_draw_buf_init(&draw_buf, buf, NULL, BUF_PIXELS);
+
+  static lv_disp_drv_t disp_drv;
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = HOR_RES;
+  disp_drv.ver_res = VER_RES;
+  disp_drv.flush_cb = panel_flush;
+  disp_drv.draw_buf = &draw_buf;
+  lv_disp_drv_register(&disp_drv);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_red);
+  RUN_TEST(test_green);
+  RUN_TEST(test_blue);
+  RUN_TEST(test_mixed);
+  return UNITY_END();
+}
@@ -0,0 +1,81 @@
+// SquareLine component child lookups (ui_comp.c): the user_data array and
+// the LV_EVENT_GET_COMP_CHILD fallback must agree, and the timing of both
+// is printed.
+
+#include "Arduino.h"
+#include "ui.h"
+#include "ui_comp.h"
+#include <lvgl.h>
+#include <unity.h>
+
+#define LOOKUPS 1000000
+
+static lv_disp_draw_buf_t draw_buf;
+static lv_color_t buf[240 * 28];
+static lv_obj_t *comp;
+
+static void dummy_flush(lv_disp_drv_t *drv, const lv_area_t *area,
+                        lv_color_t *color_p) {
+  (void)area;
+  (void)color_p;
+  lv_disp_flush_ready(drv);
+}
+
+void setUp(void) { comp = ui_Button1_create(lv_scr_act()); }
+
+void tearDown(void) { lv_obj_del(comp); }
+
+static void test_user_data_lookup(void) {
+  TEST_ASSERT_NOT_NULL(lv_obj_get_user_data(comp));
+  TEST_ASSERT_EQUAL_PTR(comp, ui_comp_get_child(comp, UI_COMP_BUTTON1_BUTTON1));
+}
+
+// As after a fresh SquareLine export: no array, the event answers
+static void test_event_fallback(void) {
+  void *children = lv_obj_get_user_data(comp);
+  lv_obj_set_user_data(comp, NULL);
+  TEST_ASSERT_EQUAL_PTR(comp, ui_comp_get_child(comp, UI_COMP_BUTTON1_BUTTON1));
+  lv_obj_set_user_data(comp, children);
+}
+
+static void test_lookup_timing(void) {
+  uint32_t miss = 0;
+  uint32_t t0 = micros();
+  for (uint32_t i = 0; i < LOOKUPS; i++)
+    miss += ui_comp_get_child(comp, UI_COMP_BUTTON1_BUTTON1) != comp;
+  uint32_t t1 = micros();
+
+  void *children = lv_obj_get_user_data(comp);
+  lv_obj_set_user_data(comp, NULL);
+  uint32_t t2 = micros();
+  for (uint32_t i = 0; i < LOOKUPS; i++)
+    miss += ui_comp_get_child(comp, UI_COMP_BUTTON1_BUTTON1) != comp;
+  uint32_t t3 = micros();
+  lv_obj_set_user_data(comp, children);
+
+  char msg[80];
+  snprintf(msg, sizeof(msg), "comp child lookups/s: user_data=%.1fM event=%.1fM",
+           LOOKUPS / (double)LV_MAX(t1 - t0, 1u),
+           LOOKUPS / (double)LV_MAX(t3 - t2, 1u));
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(0, miss);
+}
+
+int main(int argc, char **argv) {
+  lv_init();
+  lv_disp_draw_buf_init(&draw_buf, buf, NULL, sizeof(buf) / sizeof(buf[0]));
+  static lv_disp_drv_t disp_drv;
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = 240;
+  disp_drv.ver_res = 280;
+  disp_drv.flush_cb = dummy_flush;
+  disp_drv.draw_buf = &draw_buf;
+  lv_disp_drv_register(&disp_drv);
+  LV_EVENT_GET_COMP_CHILD = lv_event_register_id(); // as ui_init() does
+
+  UNITY_BEGIN();
+  RUN_TEST(test_user_data_lookup);
+  RUN_TEST(test_event_fallback);
+  RUN_TEST(test_lookup_timing);
+  return UNITY_END();
+}
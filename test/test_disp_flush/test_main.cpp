@@ -0,0 +1,140 @@
+// Flush engine (disp_flush.h) against a mock backend that completes chunks
+// only when the test says so, like the SPIM3 END interrupt would.
+
+#include "disp_flush.h"
+#include <lvgl.h>
+#include <string.h>
+#include <unity.h>
+
+#define MAX_CALLS 8
+#define FULL_FRAME_BYTES (240 * 280 * 2)
+
+typedef struct {
+  char kind; // 'S'tart or 'F'inish
+  const uint8_t *ptr;
+  uint16_t len;
+  bool first;
+  bool flushing; // LVGL still waiting when the call came
+} mock_call_t;
+
+static mock_call_t calls[MAX_CALLS];
+static int ncalls;
+static lv_disp_draw_buf_t draw_buf;
+static lv_disp_drv_t drv;
+static uint8_t frame[FULL_FRAME_BYTES];
+
+static void mock_log(char kind, const uint8_t *ptr, uint16_t len, bool first) {
+  if (ncalls < MAX_CALLS)
+    calls[ncalls] = {kind, ptr, len, first, draw_buf.flushing != 0};
+  ncalls++;
+}
+
+static void mock_start(const uint8_t *ptr, uint16_t len, bool first) {
+  mock_log('S', ptr, len, first);
+}
+
+static void mock_finish(void) { mock_log('F', NULL, 0, false); }
+
+static const disp_flush_backend_t mock_backend = {mock_start, mock_finish};
+
+// What lv_refr does before calling flush_cb
+static void begin_area(bool last) {
+  draw_buf.flushing = 1;
+  draw_buf.flushing_last = last;
+}
+
+void setUp(void) {
+  memset(calls, 0, sizeof(calls));
+  ncalls = 0;
+  memset(&draw_buf, 0, sizeof(draw_buf));
+  memset(&drv, 0, sizeof(drv));
+  drv.draw_buf = &draw_buf;
+  disp_flush_init(&mock_backend);
+}
+
+void tearDown(void) {}
+
+static void test_small_area_is_one_chunk(void) {
+  begin_area(true);
+  disp_flush_start(&drv, frame, 1000);
+  TEST_ASSERT_EQUAL_INT(1, ncalls);
+  TEST_ASSERT_EQUAL_PTR(frame, calls[0].ptr);
+  TEST_ASSERT_EQUAL_UINT16(1000, calls[0].len);
+  TEST_ASSERT_TRUE(calls[0].first);
+  // Returned with the chunk on the wire: LVGL keeps waiting
+  TEST_ASSERT_TRUE(disp_flush_busy());
+  TEST_ASSERT_EQUAL_INT(1, draw_buf.flushing);
+
+  disp_flush_chunk_done();
+  TEST_ASSERT_EQUAL_INT(2, ncalls);
+  TEST_ASSERT_EQUAL_INT('F', calls[1].kind);
+  TEST_ASSERT_FALSE(disp_flush_busy());
+  TEST_ASSERT_EQUAL_INT(0, draw_buf.flushing);
+}
+
+// A full frame is more than one 16-bit MAXCNT: 65534 + 65534 + 3332 bytes,
+// the follow-ups continuing from where TXD.PTR got to (ArrayList)
+static void test_large_area_is_split(void) {
+  begin_area(true);
+  disp_flush_start(&drv, frame, FULL_FRAME_BYTES);
+  TEST_ASSERT_EQUAL_INT(1, ncalls);
+
+  disp_flush_chunk_done();
+  disp_flush_chunk_done();
+  TEST_ASSERT_EQUAL_INT(3, ncalls);
+  TEST_ASSERT_EQUAL_INT(1, draw_buf.flushing); // not before the last chunk
+  disp_flush_chunk_done();
+  TEST_ASSERT_EQUAL_INT(4, ncalls);
+  TEST_ASSERT_EQUAL_INT(0, draw_buf.flushing);
+
+  uint32_t total = 0;
+  for (int i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL_INT('S', calls[i].kind);
+    TEST_ASSERT_EQUAL_INT(i == 0, calls[i].first);
+    TEST_ASSERT_EQUAL_PTR(i == 0 ? frame : NULL, calls[i].ptr);
+    TEST_ASSERT_LESS_OR_EQUAL(DISP_FLUSH_CHUNK_MAX, calls[i].len);
+    TEST_ASSERT_EQUAL_INT(0, calls[i].len % 2); // whole pixels
+    total += calls[i].len;
+  }
+  TEST_ASSERT_EQUAL_UINT16(DISP_FLUSH_CHUNK_MAX, calls[0].len);
+  TEST_ASSERT_EQUAL_UINT16(DISP_FLUSH_CHUNK_MAX, calls[1].len);
+  TEST_ASSERT_EQUAL_UINT32(FULL_FRAME_BYTES, total);
+
+  // The bus is released before LVGL is told the buffer is free
+  TEST_ASSERT_EQUAL_INT('F', calls[3].kind);
+  TEST_ASSERT_TRUE(calls[3].flushing);
+}
+
+static void test_empty_area_is_ready_at_once(void) {
+  begin_area(false);
+  disp_flush_start(&drv, frame, 0);
+  TEST_ASSERT_EQUAL_INT(0, ncalls);
+  TEST_ASSERT_FALSE(disp_flush_busy());
+  TEST_ASSERT_EQUAL_INT(0, draw_buf.flushing);
+}
+
+// Counters are latched by the last area of a refresh
+static void test_frame_stats(void) {
+  disp_flush_stats_t st;
+  begin_area(true); // close the refresh earlier tests left open
+  disp_flush_start(&drv, frame, 0);
+  begin_area(false);
+  disp_flush_start(&drv, frame, 4000);
+  disp_flush_chunk_done();
+  begin_area(true);
+  disp_flush_start(&drv, frame, 70000);
+  disp_flush_chunk_done();
+  disp_flush_chunk_done();
+  disp_flush_get_frame_stats(&st);
+  TEST_ASSERT_EQUAL_UINT32(2, st.areas);
+  TEST_ASSERT_EQUAL_UINT32(74000, st.bytes);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_small_area_is_one_chunk);
+  RUN_TEST(test_large_area_is_split);
+  RUN_TEST(test_empty_area_is_ready_at_once);
+  RUN_TEST(test_frame_stats);
+  return UNITY_END();
+}
@@ -0,0 +1,234 @@
+// Flick recognizer (gesture.h): strokes in, what LVGL gets to see out; then
+// the recorded trace src/sim/gestures.txt through my_ui, checking the tile
+// shown at every `expect` line.
+
+#include "Arduino.h"
+#include "gesture.h"
+#include "my_ui.h"
+#include "sim_script.h"
+#include "timekeeping.h"
+#include <lvgl.h>
+#include <unity.h>
+
+#define TRACE_PATH "src/sim/gestures.txt"
+#define TRACE_BUF_PIXELS (240 * 28)
+
+static bool accept = true; // what the stub flick handler answers
+static lv_dir_t flicked = LV_DIR_NONE;
+static uint32_t t0 = 0; // start of the current test's strokes
+
+static bool on_flick(lv_dir_t dir) {
+  flicked = dir;
+  return accept;
+}
+
+static void feed(uint32_t dt, bool down, int x, int y, uint8_t gesture = 0) {
+  sim_touch_t t = {t0 + dt, down, (lv_coord_t)x, (lv_coord_t)y, gesture};
+  touch_sample_t s = sim_script_sample(&t, 0, 0);
+  gesture_feed(&s);
+}
+
+// Straight stroke at the controller's report rate, released unless `lost`
+static void stroke(uint32_t dt, int x0, int y0, int x1, int y1, uint32_t dur,
+                   uint8_t gesture = 0, bool lost = false) {
+  for (uint32_t t = 0; t <= dur; t += SIM_SWIPE_STEP_MS)
+    feed(dt + t, true, x0 + (x1 - x0) * (int)t / (int)dur,
+         y0 + (y1 - y0) * (int)t / (int)dur);
+  if (!lost)
+    feed(dt + dur + SIM_SWIPE_STEP_MS, false, x1, y1, gesture);
+}
+
+static int drain(gesture_point_t *pts, int max) {
+  int n = 0;
+  gesture_point_t p;
+  while (gesture_pop(&p))
+    if (n < max)
+      pts[n++] = p;
+  return n;
+}
+
+void setUp(void) {
+  gesture_point_t p;
+  t0 += 10000;
+  gesture_poll(t0); // ends whatever the last test left open
+  while (gesture_pop(&p)) {
+  }
+  gesture_init(on_flick);
+  accept = true;
+  flicked = LV_DIR_NONE;
+}
+
+void tearDown(void) {}
+
+static void test_fast_stroke_is_a_flick(void) {
+  gesture_point_t pts[32];
+  uint32_t before = gesture_flicks();
+  stroke(0, 200, 140, 120, 140, 60);
+  TEST_ASSERT_EQUAL_INT(LV_DIR_LEFT, flicked);
+  TEST_ASSERT_EQUAL_UINT32(before + 1, gesture_flicks());
+  TEST_ASSERT_EQUAL_INT(0, drain(pts, 32)); // LVGL never sees it
+}
+
+// Too short for the velocity test: the slide code on release decides
+static void test_short_stroke_uses_slide_code(void) {
+  gesture_point_t pts[32];
+  stroke(0, 120, 140, 135, 140, 20, CST816S_GESTURE_SLIDE_RIGHT);
+  TEST_ASSERT_EQUAL_INT(LV_DIR_RIGHT, flicked);
+  TEST_ASSERT_EQUAL_INT(0, drain(pts, 32));
+}
+
+static void test_tap_is_replayed(void) {
+  gesture_point_t pts[32];
+  feed(0, true, 120, 250);
+  TEST_ASSERT_TRUE(gesture_pending());
+  feed(40, false, 120, 250, CST816S_GESTURE_SINGLE_CLICK);
+  TEST_ASSERT_EQUAL_INT(LV_DIR_NONE, flicked);
+  TEST_ASSERT_EQUAL_INT(2, drain(pts, 32));
+  TEST_ASSERT_TRUE(pts[0].pressed);
+  TEST_ASSERT_FALSE(pts[1].pressed);
+  TEST_ASSERT_EQUAL_INT(250, pts[1].point.y);
+}
+
+// A flick the handler turns down reaches LVGL as the stroke it was
+static void test_refused_flick_is_replayed(void) {
+  gesture_point_t pts[32];
+  accept = false;
+  stroke(0, 200, 200, 120, 200, 60);
+  TEST_ASSERT_EQUAL_INT(LV_DIR_LEFT, flicked);
+  int n = drain(pts, 32);
+  TEST_ASSERT_EQUAL_INT(60 / SIM_SWIPE_STEP_MS + 2, n);
+  TEST_ASSERT_EQUAL_INT(200, pts[0].point.x);
+  TEST_ASSERT_FALSE(pts[n - 1].pressed);
+}
+
+// Held for the window, then passed through sample by sample
+static void test_slow_drag_goes_to_lvgl(void) {
+  gesture_point_t pts[32];
+  feed(0, true, 200, 140);
+  feed(50, true, 190, 140);
+  feed(100, true, 180, 140);
+  TEST_ASSERT_EQUAL_INT(0, drain(pts, 32));
+  gesture_poll(t0 + GESTURE_FLICK_MS);
+  TEST_ASSERT_EQUAL_INT(3, drain(pts, 32));
+  feed(150, true, 170, 140);
+  TEST_ASSERT_EQUAL_INT(1, drain(pts, 32));
+  feed(200, false, 170, 140);
+  TEST_ASSERT_EQUAL_INT(1, drain(pts, 32));
+  TEST_ASSERT_FALSE(pts[0].pressed);
+  TEST_ASSERT_EQUAL_INT(LV_DIR_NONE, flicked);
+}
+
+// The read timer sleeps after a flick, so the next stroke's samples are
+// what reveal the lost UP; the stroke must not be swallowed
+static void test_lost_up_after_flick(void) {
+  gesture_point_t pts[32];
+  stroke(0, 60, 140, 150, 140, 30, 0, true);
+  TEST_ASSERT_EQUAL_INT(LV_DIR_RIGHT, flicked);
+
+  flicked = LV_DIR_NONE;
+  feed(500, true, 120, 250);
+  feed(540, false, 120, 250, CST816S_GESTURE_SINGLE_CLICK);
+  TEST_ASSERT_EQUAL_INT(LV_DIR_NONE, flicked);
+  TEST_ASSERT_EQUAL_INT(2, drain(pts, 32));
+  TEST_ASSERT_TRUE(pts[0].pressed);
+  TEST_ASSERT_EQUAL_INT(250, pts[0].point.y);
+}
+
+// LVGL saw the drag pressed: it gets a release where the finger was last
+static void test_lost_up_in_drag(void) {
+  gesture_point_t pts[32];
+  feed(0, true, 200, 140);
+  feed(50, true, 190, 140);
+  gesture_poll(t0 + GESTURE_FLICK_MS);
+  TEST_ASSERT_EQUAL_INT(2, drain(pts, 32));
+
+  gesture_poll(t0 + 50 + TOUCH_RELEASE_TIMEOUT_MS);
+  TEST_ASSERT_EQUAL_INT(0, drain(pts, 32));
+  gesture_poll(t0 + 50 + TOUCH_RELEASE_TIMEOUT_MS + 1);
+  TEST_ASSERT_EQUAL_INT(1, drain(pts, 32));
+  TEST_ASSERT_FALSE(pts[0].pressed);
+  TEST_ASSERT_EQUAL_INT(190, pts[0].point.x);
+  TEST_ASSERT_FALSE(gesture_pending());
+}
+
+static lv_disp_draw_buf_t draw_buf;
+static lv_color_t buf[TRACE_BUF_PIXELS];
+
+static void trace_flush(lv_disp_drv_t *drv, const lv_area_t *area,
+                        lv_color_t *color_p) {
+  (void)area;
+  (void)color_p;
+  lv_disp_flush_ready(drv);
+}
+
+static void trace_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+  (void)drv;
+  static gesture_point_t last = {{0, 0}, false, 0};
+  gesture_poll(millis());
+  if (gesture_pop(&last))
+    data->continue_reading = gesture_pending();
+  data->point = last.point;
+  data->state = last.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+}
+
+// The recorded trace against the real UI, as the simulator runs it
+static void test_trace_reaches_expected_tiles(void) {
+  sim_script_t script;
+  TEST_ASSERT_TRUE_MESSAGE(sim_script_load(TRACE_PATH, &script), TRACE_PATH);
+  TEST_ASSERT_TRUE(script.expects.size() > 0);
+
+  lv_init();
+  lv_disp_draw_buf_init(&draw_buf, buf, NULL, TRACE_BUF_PIXELS);
+  static lv_disp_drv_t disp_drv;
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = 240;
+  disp_drv.ver_res = 280;
+  disp_drv.flush_cb = trace_flush;
+  disp_drv.draw_buf = &draw_buf;
+  lv_disp_drv_register(&disp_drv);
+  static lv_indev_drv_t indev_drv;
+  lv_indev_drv_init(&indev_drv);
+  indev_drv.type = LV_INDEV_TYPE_POINTER;
+  indev_drv.read_cb = trace_read;
+  lv_indev_drv_register(&indev_drv);
+
+  timekeeping_init(10 * 3600 + 10 * 60);
+  my_ui_init();
+  gesture_init(my_ui_flick);
+
+  // Script times count from the start of the trace
+  uint32_t base = millis();
+  size_t touch_pos = 0;
+  for (const sim_expect_t &x : script.expects) {
+    while (millis() - base < x.t_ms) {
+      while (touch_pos < script.touches.size() &&
+             script.touches[touch_pos].t_ms <= millis() - base) {
+        sim_touch_t t = script.touches[touch_pos++];
+        t.t_ms += base;
+        touch_sample_t s = sim_script_sample(&t, 0, 0);
+        gesture_feed(&s);
+      }
+      lv_timer_handler();
+      sim_advance_ms(5);
+    }
+    uint8_t col = 0xFF, row = 0xFF;
+    my_ui_tile_id(&col, &row);
+    char msg[32];
+    snprintf(msg, sizeof(msg), "expect at %ums", (unsigned)x.t_ms);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(x.col, col, msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(x.row, row, msg);
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fast_stroke_is_a_flick);
+  RUN_TEST(test_short_stroke_uses_slide_code);
+  RUN_TEST(test_tap_is_replayed);
+  RUN_TEST(test_refused_flick_is_replayed);
+  RUN_TEST(test_slow_drag_goes_to_lvgl);
+  RUN_TEST(test_lost_up_after_flick);
+  RUN_TEST(test_lost_up_in_drag);
+  RUN_TEST(test_trace_reaches_expected_tiles);
+  return UNITY_END();
+}
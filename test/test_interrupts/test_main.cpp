@@ -0,0 +1,76 @@
+// Pin interrupt table (FunctionalInterrupt.h): every slot reaches its own
+// handler and context, without std::function.
+
+#include "Arduino.h"
+#include "FunctionalInterrupt.h"
+#include <functional>
+#include <unity.h>
+
+#define PIN0 10
+
+typedef struct {
+  int hits;
+  void isr(void) { hits++; }
+} irq_dev_t;
+
+static void add_100(void *ctx) { *(int *)ctx += 100; }
+
+void setUp(void) {}
+
+void tearDown(void) {
+  for (int i = 0; i < FI_SLOTS; i++)
+    fi_detach(PIN0 + i);
+  fi_detach(30);
+  fi_detach(31);
+}
+
+// Bound member functions, the way the CST816S library attaches
+static void test_bound_members_reach_their_object(void) {
+  irq_dev_t dev[FI_SLOTS] = {};
+  for (int i = 0; i < FI_SLOTS; i++)
+    attachInterrupt(PIN0 + i, std::bind(&irq_dev_t::isr, &dev[i]), FALLING);
+
+  for (int i = 0; i < FI_SLOTS; i++)
+    for (int n = 0; n <= i; n++)
+      sim_fire_interrupt(PIN0 + i);
+  for (int i = 0; i < FI_SLOTS; i++)
+    TEST_ASSERT_EQUAL_INT(i + 1, dev[i].hits);
+}
+
+static void test_full_table_rejects(void) {
+  irq_dev_t dev[FI_SLOTS - 1] = {};
+  int plain = 0, rejected = 0;
+  for (int i = 0; i < FI_SLOTS - 1; i++)
+    attachInterrupt(PIN0 + i, std::bind(&irq_dev_t::isr, &dev[i]), FALLING);
+  TEST_ASSERT_TRUE(fi_attach(30, add_100, &plain, RISING));
+  TEST_ASSERT_FALSE(fi_attach(31, add_100, &rejected, RISING));
+
+  sim_fire_interrupt(30);
+  sim_fire_interrupt(31);
+  TEST_ASSERT_EQUAL_INT(100, plain);
+  TEST_ASSERT_EQUAL_INT(0, rejected);
+}
+
+// Attaching a pin again replaces its handler; a detached pin is silent
+static void test_reattach_and_detach(void) {
+  irq_dev_t dev[2] = {};
+  int plain = 0;
+  attachInterrupt(PIN0, std::bind(&irq_dev_t::isr, &dev[0]), FALLING);
+  attachInterrupt(PIN0 + 1, std::bind(&irq_dev_t::isr, &dev[1]), FALLING);
+
+  fi_attach(PIN0, add_100, &plain, FALLING);
+  fi_detach(PIN0 + 1);
+  sim_fire_interrupt(PIN0);
+  sim_fire_interrupt(PIN0 + 1);
+  TEST_ASSERT_EQUAL_INT(100, plain);
+  TEST_ASSERT_EQUAL_INT(0, dev[0].hits);
+  TEST_ASSERT_EQUAL_INT(0, dev[1].hits);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_bound_members_reach_their_object);
+  RUN_TEST(test_full_table_rejects);
+  RUN_TEST(test_reattach_and_detach);
+  return UNITY_END();
+}
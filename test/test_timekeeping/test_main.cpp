@@ -0,0 +1,134 @@
+// Wall clock (timekeeping.h) on the host's fake RTC: the 24-bit counter
+// wrap, alarms across it, and the DST rules at their switch instants.
+
+#include "Arduino.h"
+#include "timekeeping.h"
+#include <unity.h>
+
+#define RTC_WRAP_TICKS (1ULL << 24)
+#define RTC_WRAP_S (uint32_t)(RTC_WRAP_TICKS / TK_RTC_HZ) // 24.3 days
+#define DAY_S 86400UL
+
+static uint64_t fake_ms = 0; // fake RTC time, all of it goes through here
+
+static void advance_ms(uint64_t ms) {
+  fake_ms += ms;
+  while (ms > 0) {
+    uint32_t step = ms > 3600000 ? 3600000 : (uint32_t)ms;
+    timekeeping_fake_advance_ms(step);
+    ms -= step;
+  }
+}
+
+// Stop `s` seconds short of the next 24-bit counter wrap
+static void advance_to_wrap_minus(uint32_t s) {
+  uint64_t ticks = fake_ms * TK_RTC_HZ / 1000;
+  uint64_t wrap_ms = ((ticks / RTC_WRAP_TICKS) + 1) * RTC_WRAP_TICKS * 1000 /
+                     TK_RTC_HZ;
+  advance_ms(wrap_ms - fake_ms - s * 1000ULL);
+}
+
+void setUp(void) {
+  timekeeping_set_zone(0, TK_DST_NONE);
+  timekeeping_take_alarm();
+}
+
+void tearDown(void) {}
+
+static void test_counts_past_the_wrap(void) {
+  timekeeping_init(1700000000);
+  uint16_t ms;
+  advance_ms(2500);
+  TEST_ASSERT_EQUAL_UINT32(1700000002, timekeeping_now(&ms));
+  TEST_ASSERT_EQUAL_UINT16(500, ms);
+
+  advance_ms((RTC_WRAP_S * 2ULL + DAY_S) * 1000); // two wraps and a day
+  TEST_ASSERT_EQUAL_UINT32(1700000002 + RTC_WRAP_S * 2 + DAY_S,
+                           timekeeping_now(&ms));
+  TEST_ASSERT_EQUAL_UINT16(500, ms);
+}
+
+// Time set just before a wrap keeps counting through it
+static void test_set_before_the_wrap(void) {
+  advance_to_wrap_minus(10);
+  timekeeping_set(1800000000);
+  advance_ms(20000);
+  TEST_ASSERT_EQUAL_UINT32(1800000020, timekeeping_now(NULL));
+}
+
+static void test_alarm_across_the_wrap(void) {
+  advance_to_wrap_minus(10);
+  uint32_t now = timekeeping_now(NULL);
+  timekeeping_arm(now + 30);
+  advance_ms(29000);
+  TEST_ASSERT_FALSE(timekeeping_take_alarm());
+  advance_ms(1000);
+  TEST_ASSERT_TRUE(timekeeping_take_alarm());
+  TEST_ASSERT_FALSE(timekeeping_take_alarm()); // once per alarm
+}
+
+// Local hour of day at UTC second `epoch`
+static int32_t local_hour(uint32_t epoch) {
+  int64_t local = (int64_t)epoch + timekeeping_local_offset(epoch);
+  return (int32_t)(local % DAY_S / 3600);
+}
+
+// Central Europe, 2024: 31 Mar 01:00 UTC and 27 Oct 01:00 UTC
+static void test_eu_dst(void) {
+  timekeeping_set_zone(60, TK_DST_EU);
+  const uint32_t spring = 1711846800, fall = 1729990800;
+  TEST_ASSERT_EQUAL_INT32(3600, timekeeping_local_offset(spring - 1));
+  TEST_ASSERT_EQUAL_INT32(7200, timekeeping_local_offset(spring));
+  TEST_ASSERT_EQUAL_INT32(1, local_hour(spring - 1)); // 01:59:59
+  TEST_ASSERT_EQUAL_INT32(3, local_hour(spring));     // 03:00, 02:xx skipped
+  TEST_ASSERT_EQUAL_INT32(7200, timekeeping_local_offset(fall - 1));
+  TEST_ASSERT_EQUAL_INT32(3600, timekeeping_local_offset(fall));
+  TEST_ASSERT_EQUAL_INT32(2, local_hour(fall - 1)); // 02:59:59 summer time
+  TEST_ASSERT_EQUAL_INT32(2, local_hour(fall));     // 02:00 again, winter
+}
+
+// US Eastern and Pacific, 2024: 10 Mar and 3 Nov at 02:00 local
+static void test_us_dst(void) {
+  static const struct {
+    int16_t zone_min;
+    uint32_t spring, fall; // UTC
+  } zones[] = {{-300, 1710054000, 1730613600}, {-480, 1710064800, 1730624400}};
+
+  for (const auto &z : zones) {
+    timekeeping_set_zone(z.zone_min, TK_DST_US);
+    int32_t std_s = z.zone_min * 60;
+    TEST_ASSERT_EQUAL_INT32(std_s, timekeeping_local_offset(z.spring - 1));
+    TEST_ASSERT_EQUAL_INT32(std_s + 3600, timekeeping_local_offset(z.spring));
+    TEST_ASSERT_EQUAL_INT32(1, local_hour(z.spring - 1));
+    TEST_ASSERT_EQUAL_INT32(3, local_hour(z.spring));
+    TEST_ASSERT_EQUAL_INT32(std_s + 3600, timekeeping_local_offset(z.fall - 1));
+    TEST_ASSERT_EQUAL_INT32(std_s, timekeeping_local_offset(z.fall));
+    TEST_ASSERT_EQUAL_INT32(1, local_hour(z.fall - 1)); // 01:59:59 daylight
+    TEST_ASSERT_EQUAL_INT32(1, local_hour(z.fall));     // 01:00 again
+  }
+}
+
+// West of UTC the first hours after epoch 0 are still 1969 locally; the
+// year must not wrap to 2106
+static void test_negative_zone_near_epoch_0(void) {
+  static const tk_dst_rule_t rules[] = {TK_DST_NONE, TK_DST_EU, TK_DST_US};
+  for (tk_dst_rule_t rule : rules) {
+    timekeeping_set_zone(-300, rule);
+    for (uint32_t t = 0; t < DAY_S; t += 600)
+      TEST_ASSERT_EQUAL_INT32(-300 * 60, timekeeping_local_offset(t));
+  }
+  // ... and a US summer instant of 1970 still gets its hour
+  timekeeping_set_zone(-300, TK_DST_US);
+  TEST_ASSERT_EQUAL_INT32(-240 * 60, timekeeping_local_offset(15552000));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_counts_past_the_wrap);
+  RUN_TEST(test_set_before_the_wrap);
+  RUN_TEST(test_alarm_across_the_wrap);
+  RUN_TEST(test_eu_dst);
+  RUN_TEST(test_us_dst);
+  RUN_TEST(test_negative_zone_near_epoch_0);
+  return UNITY_END();
+}
@@ -0,0 +1,130 @@
+// Touch filter (touch_filter.h) on the slow strokes of src/sim/drags.txt
+// with seeded +-2 px noise. Every point is compared with the scripted
+// finger at the time a frame would show it: the error along the motion is
+// lag, the rest jitter. Raw and filtered figures are printed and the
+// filtered ones must be the smaller.
+
+#include "Arduino.h"
+#include "sim_script.h"
+#include "touch_filter.h"
+#include <math.h>
+#include <unity.h>
+
+#define TRACE_PATH "src/sim/drags.txt"
+#define NOISE_PX 2
+#define SHOW_DELAY_MS 16       // sample to photons: about a 60 Hz frame
+#define MOVING_PX_PER_MS 0.05f // slower counts as resting for the lag
+
+typedef struct {
+  uint32_t points, moving;
+  double jitter2; // squared error across the motion, px^2
+  double lag_ms;
+} track_t;
+
+static sim_script_t script;
+
+void setUp(void) {
+  if (script.touches.empty())
+    TEST_ASSERT_TRUE_MESSAGE(sim_script_load(TRACE_PATH, &script), TRACE_PATH);
+}
+
+void tearDown(void) {}
+
+static int noise(uint32_t *seed) {
+  *seed = *seed * 1103515245 + 12345;
+  return (int)((*seed >> 8) % (2 * NOISE_PX + 1)) - NOISE_PX;
+}
+
+static void track(track_t *tr, lv_point_t shown, uint32_t t_show) {
+  float x, y, vx, vy;
+  sim_script_at(&script, t_show, &x, &y, &vx, &vy);
+  float ex = x - shown.x, ey = y - shown.y;
+  float err2 = ex * ex + ey * ey;
+  float speed = sqrtf(vx * vx + vy * vy);
+  if (speed > MOVING_PX_PER_MS) {
+    float along = (ex * vx + ey * vy) / speed;
+    tr->lag_ms += along / speed;
+    tr->moving++;
+    err2 -= along * along;
+  }
+  tr->jitter2 += err2;
+  tr->points++;
+}
+
+static float rms_jitter(const track_t *tr) {
+  return (float)sqrt(tr->jitter2 / tr->points);
+}
+
+static float mean_lag(const track_t *tr) {
+  return tr->moving ? (float)(tr->lag_ms / tr->moving) : 0.0f;
+}
+
+// Replays the trace through a filter with `cfg`
+static void replay(const touch_filter_cfg_t *cfg, track_t *raw,
+                   track_t *filtered) {
+  touch_filter_t f = {};
+  uint32_t seed = 1;
+  for (const sim_touch_t &t : script.touches) {
+    if (!t.pressed) {
+      touch_filter_reset(&f);
+      continue;
+    }
+    int dx = noise(&seed);
+    int dy = noise(&seed);
+    touch_sample_t s = sim_script_sample(&t, dx, dy);
+    lv_point_t p = {(lv_coord_t)s.x, (lv_coord_t)s.y};
+    touch_filter_update(&f, cfg, p.x, p.y, s.t_ms);
+    track(raw, p, s.t_ms + SHOW_DELAY_MS);
+    track(filtered, touch_filter_predict(&f, cfg, SHOW_DELAY_MS),
+          s.t_ms + SHOW_DELAY_MS);
+  }
+}
+
+static void report(const char *name, const track_t *raw,
+                   const track_t *filtered) {
+  char msg[128];
+  snprintf(msg, sizeof(msg),
+           "%s: rms jitter %.2f -> %.2f px, lag %.1f -> %.1f ms over %u "
+           "points",
+           name, rms_jitter(raw), rms_jitter(filtered), mean_lag(raw),
+           mean_lag(filtered), (unsigned)raw->points);
+  TEST_MESSAGE(msg);
+}
+
+// A resting finger without noise settles on its own point
+static void test_rest_is_exact(void) {
+  static const touch_filter_cfg_t cfg = TOUCH_FILTER_CFG_DRAG;
+  touch_filter_t f = {};
+  for (uint32_t t = 0; t < 500; t += SIM_SWIPE_STEP_MS)
+    touch_filter_update(&f, &cfg, 37, 181, t);
+  lv_point_t p = touch_filter_predict(&f, &cfg, SHOW_DELAY_MS);
+  TEST_ASSERT_EQUAL_INT(37, p.x);
+  TEST_ASSERT_EQUAL_INT(181, p.y);
+}
+
+// Smoothing only: less jitter, for some of the filter's delay
+static void test_default_smooths(void) {
+  static const touch_filter_cfg_t cfg = TOUCH_FILTER_CFG_DEFAULT;
+  track_t raw = {}, filtered = {};
+  replay(&cfg, &raw, &filtered);
+  report("default", &raw, &filtered);
+  TEST_ASSERT_LESS_THAN_FLOAT(rms_jitter(&raw), rms_jitter(&filtered));
+}
+
+// Prediction to the frame also takes out most of the display delay
+static void test_drag_smooths_and_leads(void) {
+  static const touch_filter_cfg_t cfg = TOUCH_FILTER_CFG_DRAG;
+  track_t raw = {}, filtered = {};
+  replay(&cfg, &raw, &filtered);
+  report("drag", &raw, &filtered);
+  TEST_ASSERT_LESS_THAN_FLOAT(rms_jitter(&raw), rms_jitter(&filtered));
+  TEST_ASSERT_LESS_THAN_FLOAT(mean_lag(&raw), fabsf(mean_lag(&filtered)));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_rest_is_exact);
+  RUN_TEST(test_default_smooths);
+  RUN_TEST(test_drag_smooths_and_leads);
+  return UNITY_END();
+}
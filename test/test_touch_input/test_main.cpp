@@ -0,0 +1,179 @@
+// Touch samples from the INT edge to LVGL: ISR -> touch_input_service() ->
+// SpscRing -> touch_indev_read(), with the controller's I2C answers fed
+// through the Wire shim and time stepped by hand.
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "gesture.h"
+#include "sim_script.h"
+#include "touch_indev.h"
+#include "touch_input.h"
+#include <lvgl.h>
+#include <unity.h>
+
+#define INT_PIN 7
+#define RING_DEPTH 16 // touch_input.cpp
+#define TRACE_PATH "src/sim/drags.txt"
+#define READ_PERIOD_MS 30 // LV_INDEV_DEF_READ_PERIOD
+
+static lv_timer_t *read_timer;
+static lv_indev_drv_t drv;
+static uint32_t presses;
+
+static void on_press(void) { presses++; }
+
+static void read_timer_cb(lv_timer_t *t) { (void)t; }
+
+// One CST816S report arriving: the INT edge, then the main loop's service
+static void report(bool down, uint16_t x, uint16_t y, uint8_t gesture = 0) {
+  uint8_t ev = down ? TOUCH_EVENT_CONTACT : TOUCH_EVENT_UP;
+  uint8_t raw[6] = {gesture,
+                    (uint8_t)down,
+                    (uint8_t)(ev << 6 | x >> 8),
+                    (uint8_t)x,
+                    (uint8_t)(y >> 8),
+                    (uint8_t)y};
+  Wire.feed(raw, sizeof(raw));
+  sim_fire_interrupt(INT_PIN);
+  touch_input_service();
+  if (touch_input_available())
+    lv_timer_resume(read_timer); // as loop() does
+}
+
+static lv_indev_data_t read(void) {
+  lv_indev_data_t data = {};
+  touch_indev_read(&drv, &data);
+  return data;
+}
+
+void setUp(void) {
+  presses = 0;
+  sim_advance_ms(1000); // ends whatever the last test left open
+  while (read().continue_reading) {
+  }
+}
+
+void tearDown(void) {}
+
+// A burst arriving while the ring is full is dropped, the rest keep order
+static void test_ring_overflow(void) {
+  uint32_t dropped = touch_input_dropped();
+  for (int i = 0; i < RING_DEPTH + 4; i++)
+    report(true, 10 + i, 100);
+  TEST_ASSERT_EQUAL_UINT32(dropped + 4, touch_input_dropped());
+
+  touch_sample_t s;
+  for (int i = 0; i < RING_DEPTH; i++) {
+    TEST_ASSERT_TRUE(touch_input_pop(&s));
+    TEST_ASSERT_EQUAL_UINT16(10 + i, s.x);
+    TEST_ASSERT_EQUAL_UINT16(100, s.y);
+    TEST_ASSERT_EQUAL_UINT8(TOUCH_EVENT_CONTACT, s.event);
+  }
+  TEST_ASSERT_FALSE(touch_input_available());
+}
+
+// No INT edge, no bus traffic and no sample
+static void test_service_needs_an_edge(void) {
+  uint8_t raw[6] = {0, 1, TOUCH_EVENT_CONTACT << 6, 50, 0, 50};
+  Wire.feed(raw, sizeof(raw));
+  touch_input_service();
+  TEST_ASSERT_FALSE(touch_input_available());
+  Wire.requestFrom(0, sizeof(raw)); // take the unread answer off the bus
+  while (Wire.read() >= 0) {
+  }
+}
+
+// A tap is held for the flick window and reaches LVGL on release as
+// press + release, both in one read cycle
+static void test_tap(void) {
+  report(true, 120, 250);
+  lv_indev_data_t d = read();
+  TEST_ASSERT_EQUAL_UINT32(1, presses);
+  TEST_ASSERT_EQUAL_INT(LV_INDEV_STATE_REL, d.state); // held back
+
+  sim_advance_ms(40);
+  report(false, 120, 250, CST816S_GESTURE_SINGLE_CLICK);
+  d = read();
+  TEST_ASSERT_EQUAL_INT(LV_INDEV_STATE_PR, d.state);
+  TEST_ASSERT_TRUE(d.continue_reading);
+  d = read();
+  TEST_ASSERT_EQUAL_INT(LV_INDEV_STATE_REL, d.state);
+  TEST_ASSERT_EQUAL_INT(120, d.point.x);
+  TEST_ASSERT_TRUE(read_timer->paused);
+}
+
+// A drag whose UP never arrives: LVGL stays pressed for
+// TOUCH_RELEASE_TIMEOUT_MS of silence, then sees a release
+static void test_release_timeout(void) {
+  report(true, 200, 140);
+  read();
+  sim_advance_ms(GESTURE_FLICK_MS);
+  report(true, 195, 140);
+  lv_indev_data_t d = read();
+  while (d.continue_reading)
+    d = read();
+  TEST_ASSERT_EQUAL_INT(LV_INDEV_STATE_PR, d.state);
+
+  sim_advance_ms(TOUCH_RELEASE_TIMEOUT_MS);
+  d = read();
+  TEST_ASSERT_EQUAL_INT(LV_INDEV_STATE_PR, d.state);
+  TEST_ASSERT_FALSE(read_timer->paused);
+
+  sim_advance_ms(1);
+  d = read();
+  TEST_ASSERT_EQUAL_INT(LV_INDEV_STATE_REL, d.state);
+  TEST_ASSERT_EQUAL_INT(195, d.point.x);
+  TEST_ASSERT_TRUE(read_timer->paused);
+}
+
+// Recorded strokes at the controller's report rate, read at LVGL's pace:
+// every press reaches the activity hook, every stroke ends released and
+// the ring keeps up
+static void test_recorded_trace(void) {
+  sim_script_t script;
+  TEST_ASSERT_TRUE_MESSAGE(sim_script_load(TRACE_PATH, &script), TRACE_PATH);
+
+  uint32_t dropped = touch_input_dropped();
+  uint32_t pressed = 0, strokes = 0, releases = 0;
+  uint32_t base = millis();
+  size_t pos = 0;
+  bool was_pressed = false;
+  while (pos < script.touches.size() || was_pressed) {
+    while (pos < script.touches.size() &&
+           script.touches[pos].t_ms <= millis() - base) {
+      const sim_touch_t &t = script.touches[pos++];
+      report(t.pressed, t.x, t.y, t.gesture);
+      pressed += t.pressed;
+      strokes += !t.pressed;
+    }
+    if ((millis() - base) % READ_PERIOD_MS == 0) {
+      lv_indev_data_t d;
+      do {
+        d = read();
+        releases += was_pressed && d.state == LV_INDEV_STATE_REL;
+        was_pressed = d.state == LV_INDEV_STATE_PR;
+      } while (d.continue_reading);
+    }
+    sim_advance_ms(1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(pressed, presses);
+  TEST_ASSERT_EQUAL_UINT32(strokes, releases);
+  TEST_ASSERT_EQUAL_UINT32(dropped, touch_input_dropped());
+}
+
+int main(int argc, char **argv) {
+  lv_init();
+  read_timer = lv_timer_create(read_timer_cb, 30, NULL);
+  drv.read_timer = read_timer;
+  touch_input_init(INT_PIN);
+  touch_indev_init(on_press);
+  gesture_init(NULL); // no flick handler: every stroke goes to LVGL
+
+  UNITY_BEGIN();
+  RUN_TEST(test_ring_overflow);
+  RUN_TEST(test_service_needs_an_edge);
+  RUN_TEST(test_tap);
+  RUN_TEST(test_release_timeout);
+  RUN_TEST(test_recorded_trace);
+  return UNITY_END();
+}
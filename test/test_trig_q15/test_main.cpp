@@ -0,0 +1,98 @@
+// Fixed-point trig (trig_q15.h) against libm over every tenth of a degree:
+// the header's accuracy claims are asserted, and the cost of both is
+// printed.
+
+#include "Arduino.h"
+#include "trig_q15.h"
+#include <math.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#define MAX_ERR_LSB 2
+#define MAX_ERR_PX 1
+#define MAX_HAND_LEN 120 // half the screen width
+#define TIMING_ROUNDS 100
+
+static const float kRadPerTenth = (float)M_PI / 1800.0f;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static int err_lsb(int16_t q, float ref) {
+  return abs(q - (int)lroundf(ref * TRIG_Q15_ONE));
+}
+
+static void test_sin_cos_within_2_lsb(void) {
+  int max_sin = 0, max_cos = 0;
+  for (int32_t a = 0; a < TRIG_TURN; a++) {
+    int es = err_lsb(sin_q15(a), sinf(a * kRadPerTenth));
+    int ec = err_lsb(cos_q15(a), cosf(a * kRadPerTenth));
+    if (es > max_sin)
+      max_sin = es;
+    if (ec > max_cos)
+      max_cos = ec;
+  }
+  char msg[64];
+  snprintf(msg, sizeof(msg), "max error: sin %d LSB, cos %d LSB", max_sin,
+           max_cos);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_OR_EQUAL(MAX_ERR_LSB, max_sin);
+  TEST_ASSERT_LESS_OR_EQUAL(MAX_ERR_LSB, max_cos);
+}
+
+// Angles outside one turn wrap, negative ones included
+static void test_wraps_any_turn(void) {
+  for (int32_t a = 0; a < TRIG_TURN; a++) {
+    TEST_ASSERT_EQUAL_INT16(sin_q15(a), sin_q15(a - TRIG_TURN));
+    TEST_ASSERT_EQUAL_INT16(sin_q15(a), sin_q15(a + 2 * TRIG_TURN));
+    TEST_ASSERT_EQUAL_INT16(cos_q15(a), cos_q15(a - 3 * TRIG_TURN));
+  }
+}
+
+// Hand end points land on the pixel libm would pick, or its neighbour
+static void test_hand_points_within_1_px(void) {
+  int max_px = 0;
+  for (int len = 1; len <= MAX_HAND_LEN; len++)
+    for (int32_t a = 0; a < TRIG_TURN; a++) {
+      int ex = abs(mul_q15(cos_q15(a), len) -
+                   (int)lroundf(cosf(a * kRadPerTenth) * len));
+      int ey = abs(mul_q15(sin_q15(a), len) -
+                   (int)lroundf(sinf(a * kRadPerTenth) * len));
+      if (ex > max_px)
+        max_px = ex;
+      if (ey > max_px)
+        max_px = ey;
+    }
+  TEST_ASSERT_LESS_OR_EQUAL(MAX_ERR_PX, max_px);
+}
+
+// Printed, not asserted: the host's ratio says little about the device's
+static void test_timing(void) {
+  volatile int32_t sink_q = 0;
+  volatile float sink_f = 0;
+  uint32_t t0 = micros();
+  for (int r = 0; r < TIMING_ROUNDS; r++)
+    for (int32_t a = 0; a < TRIG_TURN; a++)
+      sink_q = sink_q + sin_q15(a + r);
+  uint32_t t1 = micros();
+  for (int r = 0; r < TIMING_ROUNDS; r++)
+    for (int32_t a = 0; a < TRIG_TURN; a++)
+      sink_f = sink_f + sinf((a + r) * kRadPerTenth);
+  uint32_t t2 = micros();
+
+  char msg[80];
+  snprintf(msg, sizeof(msg), "%d calls: sin_q15 %uus, sinf %uus",
+           TIMING_ROUNDS * TRIG_TURN, (unsigned)(t1 - t0),
+           (unsigned)(t2 - t1));
+  TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sin_cos_within_2_lsb);
+  RUN_TEST(test_wraps_any_turn);
+  RUN_TEST(test_hand_points_within_1_px);
+  RUN_TEST(test_timing);
+  return UNITY_END();
+}
@@ -0,0 +1,157 @@
+"""Pre-render anti-aliased clock hand sprites (A4) for src/clock_sprites.cpp.
+
+Runs as a PlatformIO pre-build script (see extra_scripts in platformio.ini)
+and writes the tables into the build directory when the env's build_flags
+set CLOCK_SPRITES, or standalone:
+
+    python tools/gen_hand_sprites.py out.c
+
+Only the first quadrant (0 <= angle < 90 deg) is stored per hand; the other
+three are quarter-turn rotations done at blit time.
+"""
+
+import math
+import os
+import sys
+
+# name, positions per turn, length, width -- must match my_ui.cpp
+HANDS = [
+    ("hour", 120, 60, 6),
+    ("min", 60, 80, 6),
+    ("sec", 60, 90, 3),
+]
+
+SUPERSAMPLE = 4
+
+
+def coverage(px, py, tx, ty, half_w):
+    """Fraction of pixel (px, py) covered by the round-capped segment
+    (0, 0)-(tx, ty). Pixel centres sit on integer coordinates."""
+    hit = 0
+    seg_len2 = tx * tx + ty * ty
+    for sy in range(SUPERSAMPLE):
+        for sx in range(SUPERSAMPLE):
+            x = px - 0.5 + (sx + 0.5) / SUPERSAMPLE
+            y = py - 0.5 + (sy + 0.5) / SUPERSAMPLE
+            t = max(0.0, min(1.0, (x * tx + y * ty) / seg_len2))
+            dx = x - t * tx
+            dy = y - t * ty
+            if dx * dx + dy * dy <= half_w * half_w:
+                hit += 1
+    return hit / (SUPERSAMPLE * SUPERSAMPLE)
+
+
+def render(angle_deg, length, width):
+    """Return (x0, y0, w, h, rows of A4 values) relative to the pivot."""
+    a = math.radians(angle_deg)
+    tx = length * math.sin(a)
+    ty = -length * math.cos(a)
+    half_w = width / 2.0
+    pad = int(math.ceil(half_w)) + 1
+    x0 = int(math.floor(min(0.0, tx))) - pad
+    x1 = int(math.ceil(max(0.0, tx))) + pad
+    y0 = int(math.floor(min(0.0, ty))) - pad
+    y1 = int(math.ceil(max(0.0, ty))) + pad
+
+    rows = []
+    for y in range(y0, y1 + 1):
+        rows.append([int(round(coverage(x, y, tx, ty, half_w) * 15))
+                     for x in range(x0, x1 + 1)])
+
+    # Trim empty border rows / columns
+    while rows and not any(rows[0]):
+        rows.pop(0)
+        y0 += 1
+    while rows and not any(rows[-1]):
+        rows.pop()
+    while rows and not any(r[0] for r in rows):
+        rows = [r[1:] for r in rows]
+        x0 += 1
+    while rows and not any(r[-1] for r in rows):
+        rows = [r[:-1] for r in rows]
+
+    return x0, y0, len(rows[0]), len(rows), rows
+
+
+def pack_a4(rows):
+    out = []
+    for r in rows:
+        if len(r) % 2:
+            r = r + [0]
+        for i in range(0, len(r), 2):
+            out.append((r[i] << 4) | r[i + 1])
+    return out
+
+
+def generate():
+    lines = [
+        "// Generated by tools/gen_hand_sprites.py -- do not edit",
+        '#include "clock_sprites.h"',
+        "",
+    ]
+    total = 0
+    for name, positions, length, width in HANDS:
+        stored = positions // 4
+        frames = []
+        data = []
+        for p in range(stored):
+            x0, y0, w, h, rows = render(360.0 * p / positions, length, width)
+            frames.append((x0, y0, w, h, len(data)))
+            data += pack_a4(rows)
+        total += len(data)
+
+        lines.append("static const uint8_t %s_data[%d] = {" % (name, len(data)))
+        for i in range(0, len(data), 16):
+            lines.append("    " + ", ".join("0x%02x" % b
+                                          for b in data[i:i + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+        lines.append("static const clock_sprite_frame_t %s_frames[%d] = {"
+                     % (name, stored))
+        for f in frames:
+            lines.append("    {%d, %d, %d, %d, %d}," % f)
+        lines.append("};")
+        lines.append("")
+        lines.append("const clock_sprite_set_t clock_sprite_%s = {"
+                     "%d, %d, %s_frames, %s_data};"
+                     % (name, positions, stored, name, name))
+        lines.append("")
+    lines.append("// %d bytes of A4 sprite data" % total)
+    return "\n".join(lines) + "\n"
+
+
+def write_if_changed(path, text):
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == text:
+                return
+    os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+    with open(path, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    write_if_changed(sys.argv[1], generate())
+else:
+    Import("env")  # noqa: F821 (provided by PlatformIO/SCons)
+
+    def sprites_enabled(env):
+        """True when the env's build_flags define CLOCK_SPRITES non-zero.
+        Pre-scripts run before build_flags reach CPPDEFINES, so parse them."""
+        flags = env.ParseFlags(env.GetProjectOption("build_flags", []))
+        for d in flags.get("CPPDEFINES", []):
+            if isinstance(d, (list, tuple)):
+                name, value = d[0], d[1]
+            else:
+                name, value = d, "1"
+            if name == "CLOCK_SPRITES":
+                return str(value) != "0"
+        return False
+
+    if sprites_enabled(env):  # noqa: F821
+        gen_dir = os.path.join(
+            env.subst("$PROJECT_BUILD_DIR"), "gen",  # noqa: F821
+            env.subst("$PIOENV"))  # noqa: F821
+        write_if_changed(os.path.join(gen_dir, "clock_sprites_gen.c"),
+                         generate())
+        env.BuildSources(os.path.join("$BUILD_DIR", "gen"), gen_dir)  # noqa: F821